@@ -3,8 +3,9 @@
 #ifndef ARRAYLIST_H
 #define ARRAYLIST_H
 
-#include "ScopedArray.h"
+#include "ScopedBuffer.h"
 #include <cstdint>
+#include <iterator>
 
 /**
  * An array-backed list implementation that must provide strong
@@ -13,9 +14,15 @@
  * in a contiguous block of memory. This class assumes that the
  * parametrized type has a default and a copy constructor, an
  * assignment operator, and a destructor, the last of which never
- * throws an exception. For simplicity, destructors of the objects
- * stored in the ArrayList are not guaranteed to be called until the
- * ArrayList object's destructor is triggered.
+ * throws an exception.
+ *
+ * The buffer is allocated uninitialized and only the first size()
+ * slots hold constructed elements, so growing never default-constructs
+ * spare capacity and removing an element destroys it. Elements are
+ * moved into a new buffer when their move constructor cannot throw and
+ * copied otherwise, which keeps the old buffer intact until the new
+ * one is complete. Trivially copyable elements, such as pointers and
+ * numbers, are shifted with memmove and grown with realloc instead.
  */
 
 template <typename T> class ArrayList {
@@ -39,12 +46,27 @@ public:
      */
     ArrayList(const ArrayList<T>& src);
 
+    /**
+     * Creates an ArrayList holding copies of the elements of [first, last),
+     * in order, allocating the buffer once when the range can be measured.
+     * @param first the beginning of the range to copy
+     * @param last the end of the range to copy
+     */
+    template <typename InputIt,
+        typename = typename std::iterator_traits<InputIt>::iterator_category>
+    ArrayList(InputIt first, InputIt last);
+
     /**
      * Performs move constructor semantics on the provided ArrayList
      * @param src ArrayList to move
      */
     ArrayList(ArrayList<T>&& src) noexcept;
 
+    /**
+     * Destroys the elements and releases the buffer.
+     */
+    ~ArrayList();
+
     /**
      * Makes *this a deep copy of the provided ArrayList.
      * @param src ArrayList to copy
@@ -80,6 +102,69 @@ public:
      */
     const uint32_t& add(const uint32_t& index, const T& value);
 
+    /**
+     * Moves the provided element to the end of this ArrayList, growing it
+     * like add(const T&).
+     * @param value value to move in
+     * @return total array capacity
+     */
+    const uint32_t& add(T&& value);
+
+    /**
+     * Constructs a new element from args directly in the buffer at the
+     * specified index, before any previous element at that location. The
+     * ArrayList grows, and gaps are filled, like add(index, value).
+     * @param index location at which to construct the new element
+     * @param args arguments forwarded to a constructor of the template type
+     * @return a T & to the new element
+     */
+    template <typename... Args> T& emplace(uint32_t index, Args&&... args);
+
+    /**
+     * Constructs a new element from args directly in the buffer at the end
+     * of this ArrayList.
+     * @param args arguments forwarded to a constructor of the template type
+     * @return a T & to the new element
+     */
+    template <typename... Args> T& emplace_back(Args&&... args);
+
+    /**
+     * Enlarges the buffer to hold at least capacity elements, so that
+     * adding up to that many never reallocates. Never shrinks the buffer
+     * or changes the size.
+     * @param capacity the number of elements to make room for
+     */
+    void reserve(const uint32_t& capacity);
+
+    /**
+     * Shrinks the buffer to exactly size() elements.
+     */
+    void shrink_to_fit();
+
+    /**
+     * Inserts copies of the elements of [first, last) into this ArrayList
+     * at the specified index, before any previous element at that location.
+     * The capacity grows at most once and the following elements are
+     * shifted once, by the length of the range; single-pass input ranges
+     * are gathered first to measure them. Gaps are filled like
+     * add(index, value). The range must not refer to elements of this
+     * ArrayList.
+     * @param index location at which to insert the new elements
+     * @param first the beginning of the range to copy
+     * @param last the end of the range to copy
+     * @return total array capacity
+     */
+    template <typename InputIt> const uint32_t& insert(uint32_t index, InputIt first, InputIt last);
+
+    /**
+     * Appends copies of the elements of [first, last) to the end of this
+     * ArrayList, like insert(size(), first, last).
+     * @param first the beginning of the range to copy
+     * @param last the end of the range to copy
+     * @return total array capacity
+     */
+    template <typename InputIt> const uint32_t& append(InputIt first, InputIt last);
+
     /**
      * Clears this ArrayList, leaving it empty.
      */
@@ -149,6 +234,12 @@ public:
      */
     [[nodiscard]] uint32_t size() const;
 
+    /**
+     * Returns the number of elements the buffer can hold without growing.
+     * @return the capacity of this ArrayList.
+     */
+    [[nodiscard]] uint32_t capacity() const;
+
     /**
      * Perform an exception-safe swap of the contents of *this with
      * src.
@@ -158,7 +249,7 @@ private:
     /**
      * Wrapper around our physical buffer.
      */
-    ScopedArray<T> mArray;
+    ScopedBuffer<T> mArray;
 
     /**
      * The logical size of this ArrayList.
@@ -174,6 +265,65 @@ private:
      * @param index
      */
     void check_range(const uint32_t& index) const;
+
+    /**
+     * Constructs [first, last) into the uninitialized storage at dest,
+     * moving when that cannot throw and copying otherwise. If a copy
+     * throws, whatever was constructed is destroyed and [first, last) is
+     * left as it was.
+     * @return the end of the constructed range
+     */
+    static T* relocate(T* first, T* last, T* dest);
+
+    /**
+     * Copy-constructs count elements starting at first into the
+     * uninitialized storage at dest, with a single memcpy when T is
+     * trivially copyable and first points into contiguous storage of T.
+     * Nothing is left constructed if a copy throws.
+     */
+    template <typename ForwardIt>
+    static void copyConstruct(ForwardIt first, uint32_t count, T* dest);
+
+    /**
+     * Moves the constructed elements of [first, last) to dest one at a
+     * time, leaving the source slots that are not overwritten
+     * uninitialized. Only used when moving cannot throw.
+     */
+    static void shift(T* first, T* last, T* dest) noexcept;
+
+    /**
+     * Returns the capacity to grow to so that size elements fit: the
+     * current one doubled, or one when empty, until it is large enough.
+     */
+    [[nodiscard]] uint32_t grownCapacity(uint32_t size) const;
+
+    /**
+     * Relocates the elements into a new buffer of the provided capacity,
+     * leaving *this untouched if anything throws.
+     */
+    void reallocate(uint32_t capacity);
+
+    /**
+     * Performs emplace(index, args...) into a new buffer of the provided
+     * capacity, leaving *this untouched if anything throws.
+     */
+    template <typename... Args>
+    void reallocateAndEmplace(uint32_t capacity, uint32_t index, Args&&... args);
+
+    /**
+     * Inserts count copies starting at first at the specified index,
+     * shifting in place when the buffer is large enough and moving cannot
+     * throw, and through a new buffer otherwise. *this is left untouched
+     * if anything throws.
+     */
+    template <typename ForwardIt>
+    void insertCopies(uint32_t index, ForwardIt first, uint32_t count);
+
+    /**
+     * Performs remove(index) by relocating the other elements into a new
+     * buffer, for types whose move operations may throw.
+     */
+    void reallocateAndRemove(uint32_t index);
 };
 
 #include "../src/ArrayList.cpp"
@@ -1,12 +1,19 @@
 
 #include <ArrayList.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 //
 // Created by wu on 2021/4/9.
 //
 template <typename T>
 ArrayList<T>::ArrayList()
-    : mArray(nullptr)
+    : mArray()
     , mSize(0)
     , mCapacity(0)
 {
@@ -26,43 +33,44 @@ template <typename T> void ArrayList<T>::swap(ArrayList<T>& src) noexcept
 }
 template <typename T>
 ArrayList<T>::ArrayList(const uint32_t& size, const T& value)
-    : mArray(new T[size])
-    , mSize(size)
+    : mArray(size)
+    , mSize(0)
     , mCapacity(size)
 {
-    /*wrong code not strong exception safe
-    T* tmp = new T[mSize];
-    for (u_int32_t i = 0; i < mSize; i++) {
-        tmp[i] = value;
-    }
-    mArray.reset(tmp);
-    */
-    std::fill(mArray.get(), mArray.get() + mSize, value);
+    std::uninitialized_fill_n(mArray.get(), size, value);
+    mSize = size;
 }
 template <typename T>
 ArrayList<T>::ArrayList(const ArrayList<T>& src)
-    : mArray(new T[src.mCapacity]) //if exception happened, then when mArray delete ,new T[] safe delete!
-    , mSize(src.mSize)
+    : mArray(src.mCapacity)
+    , mSize(0)
     , mCapacity(src.mCapacity)
 {
-    /*not exception safe!!
-    T* tmp = new T[mCapacity];
-    for (u_int32_t i = 0; i < mSize; i++) {
-        tmp[i] = src.mArray[i];
-    }
-    mArray.reset(tmp);
-     */
-    std::copy(src.mArray.get(), src.mArray.get() + mSize, mArray.get());
+    copyConstruct(src.mArray.get(), src.mSize, mArray.get());
+    mSize = src.mSize;
+}
+template <typename T>
+template <typename InputIt, typename>
+ArrayList<T>::ArrayList(InputIt first, InputIt last)
+    : ArrayList()
+{
+    append(first, last);
 }
 template <typename T>
 ArrayList<T>::ArrayList(ArrayList<T>&& src) noexcept
-    : mArray(src.mArray.release())
+    : mArray()
     , mSize(src.mSize)
     , mCapacity(src.mCapacity)
 {
+    mArray.swap(src.mArray);
     src.mSize = src.mCapacity = 0;
-    // wrong code, should in base member initialization section
-    // mArray.reset(src.mArray.release());
+}
+/**
+ * Destroys the elements and releases the buffer.
+ */
+template <typename T> ArrayList<T>::~ArrayList()
+{
+    std::destroy_n(mArray.get(), mSize);
 }
 template <typename T> ArrayList<T>& ArrayList<T>::operator=(const ArrayList<T>& src)
 {
@@ -86,10 +94,7 @@ template <typename T> ArrayList<T>& ArrayList<T>::operator=(ArrayList<T>&& src)
     if (this == &src) {
         return *this;
     }
-    mSize = src.mSize;
-    mCapacity = src.mCapacity;
-    src.mSize = src.mCapacity = 0;
-    mArray.reset(src.mArray.release());
+    ArrayList<T>(std::move(src)).swap(*this);
     return *this;
 }
 template <typename T> const uint32_t& ArrayList<T>::add(const T& value)
@@ -114,53 +119,114 @@ template <typename T> const uint32_t& ArrayList<T>::add(const T& value)
 }
 template <typename T> const uint32_t& ArrayList<T>::add(const uint32_t& index, const T& value)
 {
-    if (index < mCapacity && mSize < mCapacity) {
-        for (u_int32_t i = mSize; i > index; i--) {
-            mArray[i] = mArray[i - 1];
+    emplace(index, value);
+    return mCapacity;
+}
+template <typename T> const uint32_t& ArrayList<T>::add(T&& value)
+{
+    emplace(mSize, std::move(value));
+    return mCapacity;
+}
+/**
+ * Past the last element the new one is constructed in place. Before it,
+ * the tail is shifted in place when moving cannot throw; the element is
+ * built first since args may refer to an element of this list. Otherwise
+ * the list is rebuilt in a new buffer, so that a throwing copy leaves it
+ * unchanged. Trivially copyable elements are also built first when
+ * growing, so that the buffer can be grown with realloc. Unlike the other
+ * methods index is taken by value, since emplace_back() passes mSize,
+ * which this changes.
+ */
+template <typename T>
+template <typename... Args>
+T& ArrayList<T>::emplace(uint32_t index, Args&&... args)
+{
+    if (index >= mCapacity || mSize >= mCapacity) {
+        if (std::max(mSize, index) == UINT32_MAX) {
+            throw std::length_error("ArrayList size would overflow");
         }
-        mArray[index] = value;
-        mSize++;
-        return mCapacity;
-    }
-    if (mCapacity == 0) {
-        mCapacity = 1;
-    }
-    while (index >= mCapacity || mSize >= mCapacity) {
-        mCapacity *= 2;
-    }
-    //Seems ok ??
-    ScopedArray<T> tmp(new T[mCapacity]);
-    //T* tmp = new T[mCapacity];
-    u_int32_t min_index = std::min(index, mSize);
-    // for (u_int32_t i = 0; i < min_index; i++) {
-    //     tmp[i] = mArray[i];
-    // }
-    std::copy(mArray.get(), mArray.get() + min_index, tmp.get());
-    if (min_index < mSize) {
-        mSize++;
-        // for (u_int32_t i = mSize; i > index; i--) {
-        //     tmp[i] = mArray[i - 1];
-        // }
-        std::copy(mArray.get() + index, mArray.get() + mSize, tmp.get() + index + 1);
-        tmp[index] = value;
-    } else {
-        /*should use fill algorithm
-        for (u_int32_t i = min_index; i < index; i++) {
-            tmp[i] = T();
+        const uint32_t capacity = grownCapacity(std::max(mSize, index) + 1);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            T value(std::forward<Args>(args)...);
+            reallocate(capacity);
+            return emplace(index, std::move(value));
+        } else {
+            reallocateAndEmplace(capacity, index, std::forward<Args>(args)...);
+            return mArray.get()[index];
+        }
+    }
+
+    T* data = mArray.get();
+    if (index >= mSize) {
+        ::new (static_cast<void*>(data + index)) T(std::forward<Args>(args)...);
+        try {
+            std::uninitialized_value_construct(data + mSize, data + index);
+        } catch (...) {
+            data[index].~T();
+            throw;
         }
-        */
-        std::fill(tmp.get() + min_index, tmp.get() + index, T());
-        tmp[index] = value;
         mSize = index + 1;
+    } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        T value(std::forward<Args>(args)...);
+        shift(data + index, data + mSize, data + index + 1);
+        ::new (static_cast<void*>(data + index)) T(std::move(value));
+        ++mSize;
+    } else {
+        reallocateAndEmplace(mCapacity, index, std::forward<Args>(args)...);
+    }
+    return mArray.get()[index];
+}
+template <typename T>
+template <typename... Args>
+T& ArrayList<T>::emplace_back(Args&&... args)
+{
+    return emplace(mSize, std::forward<Args>(args)...);
+}
+template <typename T> void ArrayList<T>::reserve(const uint32_t& capacity)
+{
+    if (capacity > mCapacity) {
+        reallocate(capacity);
+    }
+}
+template <typename T> void ArrayList<T>::shrink_to_fit()
+{
+    if (mSize < mCapacity) {
+        reallocate(mSize);
+    }
+}
+/**
+ * Ranges that can be walked twice are measured up front; single-pass ones
+ * are gathered into a temporary ArrayList whose elements are then moved.
+ */
+template <typename T>
+template <typename InputIt>
+const uint32_t& ArrayList<T>::insert(uint32_t index, InputIt first, InputIt last)
+{
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        const auto count = std::distance(first, last);
+        if (static_cast<uint64_t>(count) > UINT32_MAX) {
+            throw std::length_error("ArrayList size would overflow");
+        }
+        insertCopies(index, first, static_cast<uint32_t>(count));
+    } else {
+        ArrayList<T> items;
+        for (; first != last; ++first) {
+            items.emplace_back(*first);
+        }
+        insertCopies(index, std::make_move_iterator(items.mArray.get()), items.mSize);
     }
-    mArray.reset(tmp.release());
     return mCapacity;
 }
+template <typename T>
+template <typename InputIt>
+const uint32_t& ArrayList<T>::append(InputIt first, InputIt last)
+{
+    return insert(mSize, first, last);
+}
 template <typename T> void ArrayList<T>::clear()
 {
-    mArray.reset();
-    mSize = 0;
-    mCapacity = 0;
+    ArrayList<T>().swap(*this);
 }
 template <typename T> const T& ArrayList<T>::get(const uint32_t& index) const
 {
@@ -170,7 +236,7 @@ template <typename T> const T& ArrayList<T>::get(const uint32_t& index) const
     //    throw std::out_of_range(std::to_string(index));
     //}
     check_range(index);
-    return mArray[index];
+    return mArray.get()[index];
 }
 template <typename T> T& ArrayList<T>::get(const uint32_t& index)
 {
@@ -180,7 +246,7 @@ template <typename T> T& ArrayList<T>::get(const uint32_t& index)
     //    throw std::out_of_range(std::to_string(index));
     //}
     check_range(index);
-    return mArray[index];
+    return mArray.get()[index];
 }
 template <typename T> bool ArrayList<T>::isEmpty() const
 {
@@ -188,16 +254,20 @@ template <typename T> bool ArrayList<T>::isEmpty() const
 }
 template <typename T> T& ArrayList<T>::operator[](const uint32_t& index)
 {
-    return mArray[index];
+    return mArray.get()[index];
 }
 template <typename T> const T& ArrayList<T>::operator[](const uint32_t& index) const
 {
-    return mArray[index];
+    return mArray.get()[index];
 }
 template <typename T> uint32_t ArrayList<T>::size() const
 {
     return mSize;
 }
+template <typename T> uint32_t ArrayList<T>::capacity() const
+{
+    return mCapacity;
+}
 template <typename T> void ArrayList<T>::set(const uint32_t& index, const T& value)
 {
     //no need to check uint32 < 0
@@ -206,18 +276,23 @@ template <typename T> void ArrayList<T>::set(const uint32_t& index, const T& val
     //    throw std::out_of_range(std::to_string(index));
     //}
     check_range(index);
-    mArray[index] = value;
+    mArray.get()[index] = value;
 }
 template <typename T> T ArrayList<T>::remove(const uint32_t& index)
 {
     check_range(index);
-    T ret = mArray[index];
-    std::copy(mArray.get() + index + 1, mArray.get() + mSize, mArray.get() + index);
-    // for (uint32_t i = index + 1; i < mSize; i++) {
-    //     mArray[i - 1] = mArray[i];
-    // }
-    mSize--;
-    return ret;
+    if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        T* data = mArray.get();
+        T ret(std::move(data[index]));
+        data[index].~T();
+        shift(data + index + 1, data + mSize, data + index);
+        mSize--;
+        return ret;
+    } else {
+        T ret(mArray.get()[index]);
+        reallocateAndRemove(index);
+        return ret;
+    }
 }
 template <typename T> void ArrayList<T>::check_range(const uint32_t& index) const
 {
@@ -227,3 +302,230 @@ template <typename T> void ArrayList<T>::check_range(const uint32_t& index) cons
         throw std::out_of_range(std::to_string(index));
     }
 }
+/**
+ * Constructs [first, last) into the uninitialized storage at dest, moving
+ * when that cannot throw and copying otherwise.
+ */
+template <typename T> T* ArrayList<T>::relocate(T* first, T* last, T* dest)
+{
+    T* out = dest;
+    try {
+        for (; first != last; ++first, ++out) {
+            ::new (static_cast<void*>(out)) T(std::move_if_noexcept(*first));
+        }
+    } catch (...) {
+        std::destroy(dest, out);
+        throw;
+    }
+    return out;
+}
+/**
+ * Copies count elements starting at first into the storage at dest. Only
+ * pointers to T and the ArrayList's own iterators are known to walk
+ * contiguous storage.
+ */
+template <typename T>
+template <typename ForwardIt>
+void ArrayList<T>::copyConstruct(ForwardIt first, uint32_t count, T* dest)
+{
+    constexpr bool contiguous = std::is_same_v<ForwardIt, T*>
+        || std::is_same_v<ForwardIt, const T*>;
+    if constexpr (std::is_trivially_copyable_v<T> && contiguous) {
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(dest), &*first, count * sizeof(T));
+        }
+    } else {
+        std::uninitialized_copy_n(first, count, dest);
+    }
+}
+/**
+ * Moves [first, last) to dest, front to back when moving down and back to
+ * front when moving up, so that every element is moved out of its slot
+ * before another one is moved into it.
+ */
+template <typename T> void ArrayList<T>::shift(T* first, T* last, T* dest) noexcept
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memmove(static_cast<void*>(dest), first, (last - first) * sizeof(T));
+    } else if (dest < first) {
+        for (; first != last; ++first, ++dest) {
+            ::new (static_cast<void*>(dest)) T(std::move(*first));
+            first->~T();
+        }
+    } else {
+        for (dest += last - first; first != last;) {
+            --last;
+            --dest;
+            ::new (static_cast<void*>(dest)) T(std::move(*last));
+            last->~T();
+        }
+    }
+}
+/**
+ * Doubles the capacity, starting from one, until size elements fit. The
+ * capacity saturates at UINT32_MAX instead of wrapping around.
+ */
+template <typename T> uint32_t ArrayList<T>::grownCapacity(uint32_t size) const
+{
+    uint32_t capacity = std::max(mCapacity, 1u);
+    while (capacity < size) {
+        capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+    }
+    return capacity;
+}
+/**
+ * Relocates the elements into a fresh buffer and only destroys the old
+ * ones once they have all been constructed there. Trivially copyable
+ * elements are left to realloc instead, which may not need to copy them.
+ */
+template <typename T> void ArrayList<T>::reallocate(uint32_t capacity)
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        mArray.resize(capacity);
+        mCapacity = capacity;
+        return;
+    }
+    ScopedBuffer<T> buffer(capacity);
+    relocate(mArray.get(), mArray.get() + mSize, buffer.get());
+    std::destroy_n(mArray.get(), mSize);
+    mArray.swap(buffer);
+    mCapacity = capacity;
+}
+/**
+ * Builds the new contents in a fresh buffer: the new element first, while
+ * every element args could refer to is still in place, then the default
+ * values of any gap and only then the elements before and after index, so
+ * that nothing but relocating them can throw once they may have been
+ * moved. The old elements are only destroyed once nothing can throw any
+ * more.
+ */
+template <typename T>
+template <typename... Args>
+void ArrayList<T>::reallocateAndEmplace(uint32_t capacity, uint32_t index, Args&&... args)
+{
+    ScopedBuffer<T> buffer(capacity);
+    T* data = buffer.get();
+    T* old = mArray.get();
+    const uint32_t front = std::min(index, mSize);
+
+    ::new (static_cast<void*>(data + index)) T(std::forward<Args>(args)...);
+    try {
+        std::uninitialized_value_construct(data + front, data + index);
+    } catch (...) {
+        data[index].~T();
+        throw;
+    }
+    T* built = data;
+    try {
+        built = relocate(old, old + front, data);
+        relocate(old + front, old + mSize, data + index + 1);
+    } catch (...) {
+        std::destroy(data, built);
+        std::destroy(data + front, data + index + 1);
+        throw;
+    }
+
+    std::destroy_n(old, mSize);
+    mArray.swap(buffer);
+    mSize = std::max(mSize, index) + 1;
+    mCapacity = capacity;
+}
+/**
+ * Within capacity, with moves that cannot throw, the elements from index
+ * on are shifted up by count and the copies constructed in the hole; a
+ * throwing copy shifts them back. Otherwise the new contents are built in
+ * a fresh buffer: the copies, the default values of any gap and only then
+ * the elements before and after index, as in reallocateAndEmplace().
+ * Trivially copyable elements always take the first path, after growing
+ * with realloc.
+ */
+template <typename T>
+template <typename ForwardIt>
+void ArrayList<T>::insertCopies(uint32_t index, ForwardIt first, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count > UINT32_MAX - std::max(mSize, index)) {
+        throw std::length_error("ArrayList size would overflow");
+    }
+    const uint32_t size = std::max(mSize, index) + count;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (size > mCapacity) {
+            reallocate(grownCapacity(size));
+        }
+    }
+    if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        if (size <= mCapacity) {
+            T* data = mArray.get();
+            if (index > mSize) {
+                std::uninitialized_value_construct(data + mSize, data + index);
+                try {
+                    copyConstruct(first, count, data + index);
+                } catch (...) {
+                    std::destroy(data + mSize, data + index);
+                    throw;
+                }
+            } else {
+                shift(data + index, data + mSize, data + index + count);
+                try {
+                    copyConstruct(first, count, data + index);
+                } catch (...) {
+                    shift(data + index + count, data + mSize + count, data + index);
+                    throw;
+                }
+            }
+            mSize = size;
+            return;
+        }
+    }
+
+    const uint32_t capacity = size <= mCapacity ? mCapacity : grownCapacity(size);
+    ScopedBuffer<T> buffer(capacity);
+    T* data = buffer.get();
+    T* old = mArray.get();
+    const uint32_t front = std::min(index, mSize);
+
+    copyConstruct(first, count, data + index);
+    try {
+        std::uninitialized_value_construct(data + front, data + index);
+    } catch (...) {
+        std::destroy_n(data + index, count);
+        throw;
+    }
+    T* built = data;
+    try {
+        built = relocate(old, old + front, data);
+        relocate(old + front, old + mSize, data + index + count);
+    } catch (...) {
+        std::destroy(data, built);
+        std::destroy(data + front, data + index + count);
+        throw;
+    }
+
+    std::destroy_n(old, mSize);
+    mArray.swap(buffer);
+    mSize = size;
+    mCapacity = capacity;
+}
+/**
+ * Relocates every element but the one at index into a buffer of the same
+ * capacity.
+ */
+template <typename T> void ArrayList<T>::reallocateAndRemove(uint32_t index)
+{
+    ScopedBuffer<T> buffer(mCapacity);
+    T* data = buffer.get();
+    T* old = mArray.get();
+    T* built = relocate(old, old + index, data);
+    try {
+        relocate(old + index + 1, old + mSize, built);
+    } catch (...) {
+        std::destroy(data, built);
+        throw;
+    }
+
+    std::destroy_n(old, mSize);
+    mArray.swap(buffer);
+    mSize--;
+}
@@ -0,0 +1,63 @@
+// @author G. Hemingway, copyright 2020 - All rights reserved
+
+#ifndef SCOPEDBUFFER_CPP
+#define SCOPEDBUFFER_CPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+ScopedBuffer<T>::ScopedBuffer(size_t count)
+    : buffer(nullptr)
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+    if (count == 0) {
+        return;
+    }
+    if (count > SIZE_MAX / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    buffer = static_cast<T*>(std::malloc(count * sizeof(T)));
+    if (buffer == nullptr) {
+        throw std::bad_alloc();
+    }
+}
+
+template <typename T> ScopedBuffer<T>::~ScopedBuffer()
+{
+    std::free(buffer);
+}
+
+template <typename T> T* ScopedBuffer<T>::get() const
+{
+    return buffer;
+}
+
+template <typename T> void ScopedBuffer<T>::resize(size_t count)
+{
+    static_assert(
+        std::is_trivially_copyable_v<T>, "realloc only preserves trivially copyable types");
+    if (count == 0) {
+        std::free(buffer);
+        buffer = nullptr;
+        return;
+    }
+    if (count > SIZE_MAX / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    void* resized = std::realloc(buffer, count * sizeof(T));
+    if (resized == nullptr) {
+        throw std::bad_alloc();
+    }
+    buffer = static_cast<T*>(resized);
+}
+
+template <typename T> void ScopedBuffer<T>::swap(ScopedBuffer& rhs) noexcept
+{
+    std::swap(buffer, rhs.buffer);
+}
+
+#endif // SCOPEDBUFFER_CPP
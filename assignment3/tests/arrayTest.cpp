@@ -2,6 +2,13 @@
 
 #include "ArrayList.h"
 #include <gtest/gtest.h>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace {
 // The fixture for testing ArrayList and ArrayListIterator.
@@ -283,4 +290,376 @@ TEST_F(ArrayListTest, Clear)
     EXPECT_DEATH({ a[0] = 100L; }, "");
 }
 
+/**
+ * An element type that counts its live instances and copies. Its copy
+ * constructor throws once throwAfter more copies have been made, and it
+ * has no move constructor, so the ArrayList has to copy it.
+ */
+struct Tracked {
+    static inline int live = 0;
+    static inline int copies = 0;
+    static inline int throwAfter = -1;
+
+    explicit Tracked(int value = 0)
+        : value(value)
+    {
+        ++live;
+    }
+
+    Tracked(const Tracked& rhs)
+        : value(rhs.value)
+    {
+        if (throwAfter == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        if (throwAfter > 0) {
+            --throwAfter;
+        }
+        ++copies;
+        ++live;
+    }
+
+    Tracked& operator=(const Tracked& rhs) = default;
+
+    ~Tracked()
+    {
+        --live;
+    }
+
+    int value;
+};
+
+// Only the elements in the list are ever constructed
+TEST_F(ArrayListTest, OnlyLiveElements)
+{
+    Tracked::live = 0;
+    {
+        ArrayList<Tracked> a;
+        for (int i = 0; i < 100; ++i) {
+            a.add(Tracked(i));
+        }
+        EXPECT_EQ(Tracked::live, 100);
+        a.remove(0);
+        EXPECT_EQ(Tracked::live, 99);
+        EXPECT_EQ(a[0].value, 1);
+        a.add(10, Tracked(-1));
+        EXPECT_EQ(Tracked::live, 100);
+        EXPECT_EQ(a[10].value, -1);
+        EXPECT_EQ(a[11].value, 11);
+        a.clear();
+        EXPECT_EQ(Tracked::live, 0);
+        a.add(Tracked(5));
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// A copy that throws while growing leaves the list unchanged
+TEST_F(ArrayListTest, StrongGuaranteeWhileGrowing)
+{
+    Tracked::live = 0;
+    {
+        ArrayList<Tracked> a;
+        for (int i = 0; i < 4; ++i) {
+            a.add(Tracked(i));
+        }
+        Tracked::throwAfter = 2;
+        EXPECT_THROW(a.add(Tracked(4)), std::runtime_error);
+        Tracked::throwAfter = 2;
+        EXPECT_THROW(a.add(1, Tracked(4)), std::runtime_error);
+        Tracked::throwAfter = -1;
+        EXPECT_EQ(a.size(), 4U);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(a[i].value, i);
+        }
+        EXPECT_EQ(Tracked::live, 4);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+/**
+ * An element whose moves never throw and whose default constructor throws
+ * while failDefault is set, to fail filling the gap before an index past
+ * the end.
+ */
+struct GapFilled {
+    static inline bool failDefault = false;
+
+    GapFilled()
+    {
+        if (failDefault) {
+            throw std::runtime_error("default construction failed");
+        }
+    }
+
+    explicit GapFilled(std::string text)
+        : text(std::move(text))
+    {
+    }
+
+    GapFilled(const GapFilled& rhs) = default;
+    GapFilled(GapFilled&& rhs) noexcept = default;
+    GapFilled& operator=(const GapFilled& rhs) = default;
+    GapFilled& operator=(GapFilled&& rhs) noexcept = default;
+
+    std::string text;
+};
+
+// Failing to fill the gap while growing leaves the elements in place
+TEST_F(ArrayListTest, StrongGuaranteeFillingGap)
+{
+    ArrayList<GapFilled> a;
+    a.add(GapFilled(std::string(32, 'a')));
+    a.add(GapFilled(std::string(32, 'b')));
+    GapFilled::failDefault = true;
+    EXPECT_THROW(a.add(5, GapFilled("x")), std::runtime_error);
+    EXPECT_THROW(a.emplace(5, "x"), std::runtime_error);
+    const GapFilled values[] = { GapFilled("x"), GapFilled("y") };
+    EXPECT_THROW(a.insert(5, std::begin(values), std::end(values)), std::runtime_error);
+    GapFilled::failDefault = false;
+    ASSERT_EQ(a.size(), 2U);
+    EXPECT_EQ(a.capacity(), 2U);
+    EXPECT_EQ(a[0].text, std::string(32, 'a'));
+    EXPECT_EQ(a[1].text, std::string(32, 'b'));
+}
+
+// Adding an element of the list itself, with and without growing
+TEST_F(ArrayListTest, AddOwnElement)
+{
+    ArrayList<std::string> a;
+    a.add(std::string(32, 'a'));
+    a.add(std::string(32, 'b'));
+    a.add(0, a[1]);
+    a.add(0, a[2]);
+    EXPECT_EQ(a.size(), 4U);
+    EXPECT_EQ(a[0], std::string(32, 'b'));
+    EXPECT_EQ(a[1], std::string(32, 'b'));
+    EXPECT_EQ(a[2], std::string(32, 'a'));
+    EXPECT_EQ(a[3], std::string(32, 'b'));
+}
+
+// A reserved list is built in place without reallocating or copying
+TEST_F(ArrayListTest, ReserveAndEmplace)
+{
+    const uint32_t count = 1000000;
+    Tracked::live = 0;
+    Tracked::copies = 0;
+    {
+        ArrayList<Tracked> a;
+        a.reserve(count);
+        const Tracked* data = &a.emplace_back(0);
+        for (uint32_t i = 1; i < count; ++i) {
+            a.emplace_back(static_cast<int>(i));
+        }
+        EXPECT_EQ(&a[0], data);
+        EXPECT_EQ(a.size(), count);
+        EXPECT_EQ(a.capacity(), count);
+        EXPECT_EQ(a[count - 1].value, static_cast<int>(count - 1));
+        EXPECT_EQ(Tracked::copies, 0);
+        EXPECT_EQ(Tracked::live, static_cast<int>(count));
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// Move-only elements can be added and emplaced
+TEST_F(ArrayListTest, MoveOnlyElements)
+{
+    ArrayList<std::unique_ptr<int>> a;
+    a.add(std::make_unique<int>(2));
+    a.emplace(0, new int(0));
+    a.emplace(1, new int(1));
+    a.emplace_back(new int(3));
+    a.remove(3);
+    ASSERT_EQ(a.size(), 3U);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(*a[i], i);
+    }
+}
+
+// Reserving never shrinks and shrink_to_fit trims the spare capacity
+TEST_F(ArrayListTest, ReserveAndShrink)
+{
+    ArrayList<std::string> a;
+    a.add(std::string(32, 'a'));
+    a.add(std::string(32, 'b'));
+    a.add(std::string(32, 'c'));
+    EXPECT_EQ(a.capacity(), 4U);
+    a.reserve(2);
+    EXPECT_EQ(a.capacity(), 4U);
+    a.reserve(10);
+    EXPECT_EQ(a.capacity(), 10U);
+    a.shrink_to_fit();
+    EXPECT_EQ(a.capacity(), 3U);
+    EXPECT_EQ(a.size(), 3U);
+    EXPECT_EQ(a[2], std::string(32, 'c'));
+    a.clear();
+    a.shrink_to_fit();
+    EXPECT_EQ(a.capacity(), 0U);
+}
+
+/**
+ * A Tracked whose moves never throw, so the ArrayList shifts it in place
+ * and only its copies can fail.
+ */
+struct MovableTracked : Tracked {
+    using Tracked::Tracked;
+
+    MovableTracked(const MovableTracked& rhs) = default;
+
+    MovableTracked(MovableTracked&& rhs) noexcept
+        : Tracked(rhs.value)
+    {
+    }
+
+    MovableTracked& operator=(const MovableTracked& rhs) = default;
+
+    MovableTracked& operator=(MovableTracked&& rhs) noexcept
+    {
+        value = rhs.value;
+        return *this;
+    }
+};
+
+// Constructing from ranges of every iterator category
+TEST_F(ArrayListTest, RangeConstructor)
+{
+    const int values[] = { 1, 2, 3, 4, 5 };
+    ArrayList<int> a(std::begin(values), std::end(values));
+    EXPECT_EQ(a.size(), 5U);
+    EXPECT_EQ(a.capacity(), 8U);
+    EXPECT_EQ(a[4], 5);
+
+    std::vector<std::string> words = { "one", "two", "three" };
+    ArrayList<std::string> b(words.begin(), words.end());
+    ASSERT_EQ(b.size(), 3U);
+    EXPECT_EQ(b[2], "three");
+
+    std::istringstream stream("7 8 9");
+    ArrayList<int> c((std::istream_iterator<int>(stream)), std::istream_iterator<int>());
+    ASSERT_EQ(c.size(), 3U);
+    EXPECT_EQ(c[0], 7);
+    EXPECT_EQ(c[2], 9);
+
+    // Two integers still select the fill constructor
+    ArrayList<int> d(3, 5);
+    EXPECT_EQ(d.size(), 3U);
+    EXPECT_EQ(d[2], 5);
+}
+
+// Inserting a range shifts the tail once and grows the buffer once
+TEST_F(ArrayListTest, InsertRange)
+{
+    const long values[] = { 100, 101, 102 };
+    ArrayList<long> a;
+    for (long i = 0; i < 6; ++i) {
+        a.add(i);
+    }
+    a.insert(2, std::begin(values), std::end(values));
+    const long expected[] = { 0, 1, 100, 101, 102, 2, 3, 4, 5 };
+    ASSERT_EQ(a.size(), 9U);
+    EXPECT_EQ(a.capacity(), 16U);
+    for (uint32_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i], expected[i]);
+    }
+
+    a.append(std::begin(values), std::end(values));
+    EXPECT_EQ(a.size(), 12U);
+    EXPECT_EQ(a[11], 102);
+
+    a.insert(14, std::begin(values), std::begin(values) + 1);
+    EXPECT_EQ(a.size(), 15U);
+    EXPECT_EQ(a[12], 0);
+    EXPECT_EQ(a[14], 100);
+
+    a.insert(0, std::begin(values), std::begin(values));
+    EXPECT_EQ(a.size(), 15U);
+}
+
+// Inserting non-trivial elements in place and while growing
+TEST_F(ArrayListTest, InsertRangeOfStrings)
+{
+    std::list<std::string> words = { std::string(32, 'x'), std::string(32, 'y') };
+    ArrayList<std::string> a;
+    a.reserve(8);
+    a.add(std::string(32, 'a'));
+    a.add(std::string(32, 'b'));
+    a.insert(1, words.begin(), words.end());
+    a.insert(0, words.begin(), words.end());
+    a.insert(3, words.begin(), words.end());
+    ASSERT_EQ(a.size(), 8U);
+    EXPECT_EQ(a.capacity(), 8U);
+    const char expected[] = "xyaxyxyb";
+    for (uint32_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i], std::string(32, expected[i]));
+    }
+    a.append(words.begin(), words.end());
+    EXPECT_EQ(a.capacity(), 16U);
+    EXPECT_EQ(a[9], std::string(32, 'y'));
+}
+
+// A copy that throws while inserting a range leaves the list unchanged
+TEST_F(ArrayListTest, InsertRangeStrongGuarantee)
+{
+    Tracked::live = 0;
+    {
+        std::vector<MovableTracked> movable(3, MovableTracked(-1));
+        std::vector<Tracked> copyable(3, Tracked(-1));
+        ArrayList<MovableTracked> a;
+        ArrayList<Tracked> b;
+        a.reserve(8);
+        b.reserve(8);
+        for (int i = 0; i < 4; ++i) {
+            a.emplace_back(i);
+            b.emplace_back(i);
+        }
+        const int live = Tracked::live;
+        Tracked::throwAfter = 1;
+        EXPECT_THROW(a.insert(1, movable.begin(), movable.end()), std::runtime_error);
+        Tracked::throwAfter = 1;
+        EXPECT_THROW(b.insert(1, copyable.begin(), copyable.end()), std::runtime_error);
+        Tracked::throwAfter = 1;
+        EXPECT_THROW(b.append(copyable.begin(), copyable.end()), std::runtime_error);
+        Tracked::throwAfter = -1;
+        EXPECT_EQ(Tracked::live, live);
+        ASSERT_EQ(a.size(), 4U);
+        ASSERT_EQ(b.size(), 4U);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(a[i].value, i);
+            EXPECT_EQ(b[i].value, i);
+        }
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// Pointers are shifted with memmove and grown with realloc
+TEST_F(ArrayListTest, TriviallyCopyableElements)
+{
+    int values[64];
+    ArrayList<int*> a;
+    for (int i = 0; i < 64; ++i) {
+        values[i] = i;
+        a.add(0, &values[i]);
+    }
+    EXPECT_EQ(a.capacity(), 64U);
+    a.remove(10);
+    a.remove(0);
+    ASSERT_EQ(a.size(), 62U);
+    EXPECT_EQ(*a[0], 62);
+    EXPECT_EQ(*a[9], 52);
+    EXPECT_EQ(*a[61], 0);
+
+    // An element of a full list is read before the buffer is reallocated
+    a.add(0, a[61]);
+    a.add(a[1]);
+    a.add(a[1]);
+    EXPECT_EQ(a.capacity(), 128U);
+    EXPECT_EQ(*a[0], 0);
+    EXPECT_EQ(*a[62], 0);
+    EXPECT_EQ(*a[63], 62);
+    EXPECT_EQ(*a[64], 62);
+
+    a.shrink_to_fit();
+    EXPECT_EQ(a.capacity(), 65U);
+    EXPECT_EQ(*a[64], 62);
+}
+
 } // Namespace
@@ -0,0 +1,176 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "ArrayList.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+/**
+ *  Measures appending state.range(0) elements to an empty ArrayList.
+ */
+static void BM_ArrayListAdd(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        ArrayList<double> list;
+        for (uint32_t i = 0; i < count; ++i) {
+            list.add(i);
+        }
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArrayListAdd)->RangeMultiplier(8)->Range(8, 1 << 18);
+
+/**
+ *  Measures inserting state.range(0) elements at the front of an empty
+ *  ArrayList, which shifts every element already stored.
+ */
+static void BM_ArrayListAddFront(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        ArrayList<double> list;
+        for (uint32_t i = 0; i < count; ++i) {
+            list.add(0, i);
+        }
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_ArrayListAddFront)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Complexity(benchmark::oNSquared);
+
+/**
+ *  Measures removing every element of an ArrayList of state.range(0)
+ *  elements from the front. Filling the list is not timed.
+ */
+static void BM_ArrayListRemoveFront(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        ArrayList<double> list(count, 1.0);
+        state.ResumeTiming();
+        for (uint32_t i = 0; i < count; ++i) {
+            list.remove(0);
+        }
+        benchmark::DoNotOptimize(list.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_ArrayListRemoveFront)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Complexity(benchmark::oNSquared);
+
+/**
+ *  Measures removing every element of an ArrayList of state.range(0)
+ *  elements from the back. Filling the list is not timed.
+ */
+static void BM_ArrayListRemoveBack(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        ArrayList<double> list(count, 1.0);
+        state.ResumeTiming();
+        for (uint32_t i = count; i > 0; --i) {
+            list.remove(i - 1);
+        }
+        benchmark::DoNotOptimize(list.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArrayListRemoveBack)->RangeMultiplier(8)->Range(8, 1 << 18);
+
+/**
+ *  Measures appending state.range(0) strings too long for the small
+ *  string buffer, so that every copy made while growing allocates.
+ */
+static void BM_ArrayListAddStrings(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    const std::string value(64, 'x');
+    for (auto _ : state) {
+        ArrayList<std::string> list;
+        for (uint32_t i = 0; i < count; ++i) {
+            list.add(value);
+        }
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArrayListAddStrings)->RangeMultiplier(8)->Range(8, 1 << 18);
+
+/**
+ *  Measures the same strings as BM_ArrayListAddStrings constructed in
+ *  place into a list reserved up front, which allocates the buffer once
+ *  and never copies or moves a string.
+ */
+static void BM_ArrayListEmplaceStrings(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        ArrayList<std::string> list;
+        list.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            list.emplace_back(64, 'x');
+        }
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArrayListEmplaceStrings)->RangeMultiplier(8)->Range(8, 1 << 18);
+
+/**
+ *  Measures inserting 1024 doubles one at a time into the middle of an
+ *  ArrayList of state.range(0) elements, which shifts the tail once per
+ *  element. Filling the list is not timed.
+ */
+static void BM_ArrayListInsertLoop(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    const std::vector<double> values(1024, 2.0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        ArrayList<double> list(count, 1.0);
+        state.ResumeTiming();
+        for (uint32_t i = 0; i < values.size(); ++i) {
+            list.add(count / 2 + i, values[i]);
+        }
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_ArrayListInsertLoop)->RangeMultiplier(8)->Range(1 << 12, 1 << 18);
+
+/**
+ *  Measures the insertion of BM_ArrayListInsertLoop as a single range,
+ *  which grows the buffer once and shifts the tail once.
+ */
+static void BM_ArrayListInsertRange(benchmark::State& state)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    const std::vector<double> values(1024, 2.0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        ArrayList<double> list(count, 1.0);
+        state.ResumeTiming();
+        list.insert(count / 2, values.begin(), values.end());
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_ArrayListInsertRange)->RangeMultiplier(8)->Range(1 << 12, 1 << 18);
@@ -0,0 +1,128 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef BENCHMARKHELPER_H
+#define BENCHMARKHELPER_H
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "CompositeObject.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include "vector2.h"
+
+/**
+ *  A helper method for creating 2 dimensional vectors.
+ */
+inline vector2 makeVector2(double x = 0, double y = 0)
+{
+    vector2 v;
+    v[0] = x;
+    v[1] = y;
+    return v;
+}
+
+/**
+ *  Populates the Universe with a sun followed by count - 1 earth-like
+ *  bodies on circular orbits scattered over a disk. The layout only
+ *  depends on count and seed so runs are comparable across builds.
+ */
+inline void makeDisk(uint32_t count, uint32_t seed = 3251)
+{
+    const double sunMass = 1.98892e30;
+    const double pi = std::acos(-1.0);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> radius(0.5e11, 5e11);
+    std::uniform_real_distribution<double> angle(0, 2 * pi);
+
+    ObjectFactory::makeObject("sun", sunMass);
+    for (uint32_t i = 1; i < count; ++i) {
+        double r = radius(rng);
+        double a = angle(rng);
+        double speed = std::sqrt(Universe::G * sunMass / r);
+        ObjectFactory::makeObject("body" + std::to_string(i), 5.9742e24,
+            makeVector2(r * std::cos(a), r * std::sin(a)),
+            makeVector2(-speed * std::sin(a), speed * std::cos(a)));
+    }
+}
+
+/**
+ *  Populates the Universe with a sun followed by count - 1 earth-like
+ *  bodies on circular orbits of evenly spaced radii and random phases.
+ *  Unlike makeDisk() no two orbits cross, so there are no close
+ *  encounters and the energy error only reflects the integrator.
+ */
+inline void makeRings(uint32_t count, uint32_t seed = 3251)
+{
+    const double sunMass = 1.98892e30;
+    const double pi = std::acos(-1.0);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> angle(0, 2 * pi);
+
+    ObjectFactory::makeObject("sun", sunMass);
+    for (uint32_t i = 1; i < count; ++i) {
+        double r = 0.5e11 + 4.5e11 * (i - 1) / count;
+        double a = angle(rng);
+        double speed = std::sqrt(Universe::G * sunMass / r);
+        ObjectFactory::makeObject("body" + std::to_string(i), 5.9742e24,
+            makeVector2(r * std::cos(a), r * std::sin(a)),
+            makeVector2(-speed * std::sin(a), speed * std::cos(a)));
+    }
+}
+
+/**
+ *  Populates the Universe with a sun followed by systems jupiter-like
+ *  planets scattered over a disk, each circled by moons moons within a
+ *  few million kilometers and grouped with them in a composite.
+ */
+inline void makeSystems(uint32_t systems, uint32_t moons, uint32_t seed = 3251)
+{
+    const double sunMass = 1.98892e30;
+    const double planetMass = 1.8986e27;
+    const double pi = std::acos(-1.0);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> radius(0.5e11, 5e11);
+    std::uniform_real_distribution<double> moonRadius(0.4e9, 2e9);
+    std::uniform_real_distribution<double> angle(0, 2 * pi);
+
+    ObjectFactory::makeObject("sun", sunMass);
+    for (uint32_t i = 0; i < systems; ++i) {
+        double r = radius(rng);
+        double a = angle(rng);
+        double speed = std::sqrt(Universe::G * sunMass / r);
+        vector2 pos = makeVector2(r * std::cos(a), r * std::sin(a));
+        vector2 vel = makeVector2(-speed * std::sin(a), speed * std::cos(a));
+        CompositeObject* system = ObjectFactory::makeComposite("system" + std::to_string(i));
+        system->add(ObjectFactory::makeObject("planet" + std::to_string(i), planetMass, pos, vel));
+        for (uint32_t j = 0; j < moons; ++j) {
+            double mr = moonRadius(rng);
+            double ma = angle(rng);
+            double moonSpeed = std::sqrt(Universe::G * planetMass / mr);
+            system->add(ObjectFactory::makeObject(
+                "moon" + std::to_string(i) + "_" + std::to_string(j), 8.9319e22,
+                pos + makeVector2(mr * std::cos(ma), mr * std::sin(ma)),
+                vel + makeVector2(-moonSpeed * std::sin(ma), moonSpeed * std::cos(ma))));
+        }
+    }
+}
+
+/**
+ *  Writes a scene file in the Parser's format with a sun followed by
+ *  count - 1 bodies at random positions and velocities.
+ */
+inline void writeScene(const char* filename, uint32_t count, uint32_t seed = 3251)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coord(-5e11, 5e11);
+    std::uniform_real_distribution<double> speed(-3e4, 3e4);
+    std::ofstream file(filename);
+    file.precision(17);
+    file << "{sun, 1.98892e30, [0 0], [0 0]}\n";
+    for (uint32_t i = 1; i < count; ++i) {
+        file << "{body" << i << ", 5.9742e24, [" << coord(rng) << " " << coord(rng) << "], ["
+             << speed(rng) << " " << speed(rng) << "]}\n";
+    }
+}
+
+#endif // BENCHMARKHELPER_H
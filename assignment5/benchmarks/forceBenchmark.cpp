@@ -0,0 +1,265 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./benchmarkHelper.h"
+#include "Object.h"
+#include "Universe.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+
+/**
+ *  Measures one simulation step over a disk of state.range(0) bodies
+ *  using the provided force method.
+ */
+static void BM_StepSimulation(benchmark::State& state, Universe::ForceMethod method)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setForceMethod(method);
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        univ->stepSimulation(1);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_StepSimulation, BruteForce, Universe::ForceMethod::BruteForce)
+    ->RangeMultiplier(8)
+    ->Range(2, 100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oNSquared);
+
+BENCHMARK_CAPTURE(BM_StepSimulation, Symmetric, Universe::ForceMethod::Symmetric)
+    ->RangeMultiplier(8)
+    ->Range(2, 32 << 10)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oNSquared);
+
+BENCHMARK_CAPTURE(BM_StepSimulation, BarnesHut, Universe::ForceMethod::BarnesHut)
+    ->RangeMultiplier(8)
+    ->Range(2, 100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oNLogN);
+
+/**
+ *  Measures one simulation step over state.range(0) planetary systems of
+ *  a planet and 15 moons each, grouped in composites, using the provided
+ *  force method.
+ */
+static void BM_StepSystems(benchmark::State& state, Universe::ForceMethod method)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setForceMethod(method);
+    makeSystems(static_cast<uint32_t>(state.range(0)), 15);
+    for (auto _ : state) {
+        univ->stepSimulation(1);
+    }
+    state.SetItemsProcessed(state.iterations() * univ->getBodies().size());
+}
+
+BENCHMARK_CAPTURE(BM_StepSystems, BruteForce, Universe::ForceMethod::BruteForce)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_StepSystems, BarnesHut, Universe::ForceMethod::BarnesHut)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_StepSystems, Composite, Universe::ForceMethod::Composite)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures one brute-force step over a disk of state.range(0) bodies
+ *  spread over state.range(1) threads.
+ */
+static void BM_StepSimulationThreads(benchmark::State& state)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setThreadCount(static_cast<unsigned>(state.range(1)));
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        univ->stepSimulation(1);
+    }
+}
+
+BENCHMARK(BM_StepSimulationThreads)
+    ->ArgsProduct({ { 1 << 10, 4 << 10 }, { 1, 2, 4, 8 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/**
+ *  Measures one brute-force step over a disk of state.range(0) bodies
+ *  with the pairwise kernel compiled for the provided instruction set.
+ */
+static void BM_StepSimulationSimd(benchmark::State& state, gravity::SimdLevel level)
+{
+    if (!gravity::isSupported(level)) {
+        state.SkipWithError("instruction set not supported");
+        return;
+    }
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setSimdLevel(level);
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        univ->stepSimulation(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (state.range(0) - 1));
+}
+
+BENCHMARK_CAPTURE(BM_StepSimulationSimd, Scalar, gravity::SimdLevel::Scalar)->Arg(4 << 10);
+BENCHMARK_CAPTURE(BM_StepSimulationSimd, SSE2, gravity::SimdLevel::SSE2)->Arg(4 << 10);
+BENCHMARK_CAPTURE(BM_StepSimulationSimd, AVX2, gravity::SimdLevel::AVX2)->Arg(4 << 10);
+BENCHMARK_CAPTURE(BM_StepSimulationSimd, AVX512, gravity::SimdLevel::AVX512)->Arg(4 << 10);
+
+/**
+ *  Measures the wall-clock time one integrator needs to advance 16 bodies
+ *  on rings around the sun by a year in state.range(0) steps, and reports the relative
+ *  change in total energy over that year as energy_drift. Comparing
+ *  schemes at equal drift shows which one reaches a given accuracy
+ *  fastest.
+ */
+static void BM_Integrator(benchmark::State& state, Universe::Integrator scheme)
+{
+    const double year = 31554195.932106005998594489072144;
+    const auto steps = static_cast<int>(state.range(0));
+    double drift = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setIntegrator(scheme);
+        makeRings(16);
+        double initial = univ->getEnergy();
+        state.ResumeTiming();
+
+        for (int step = 0; step < steps; ++step) {
+            univ->stepSimulation(year / steps);
+        }
+
+        state.PauseTiming();
+        drift = std::abs((univ->getEnergy() - initial) / initial);
+        univ.reset();
+        state.ResumeTiming();
+    }
+    state.counters["energy_drift"] = drift;
+}
+
+BENCHMARK_CAPTURE(BM_Integrator, Euler, Universe::Integrator::Euler)
+    ->RangeMultiplier(4)
+    ->Range(256, 16 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_Integrator, Leapfrog, Universe::Integrator::Leapfrog)
+    ->RangeMultiplier(4)
+    ->Range(256, 16 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_Integrator, Yoshida4, Universe::Integrator::Yoshida4)
+    ->RangeMultiplier(4)
+    ->Range(256, 16 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_Integrator, RK4, Universe::Integrator::RK4)
+    ->RangeMultiplier(4)
+    ->Range(256, 16 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures the wall-clock time one integrator needs to take a comet with
+ *  eccentricity 0.9 once around its orbit in state.range(0) steps, among
+ *  64 bodies on rings around the sun, and reports how far from its
+ *  starting point the comet ends up as comet_error in meters. With a
+ *  global step the whole system must step as finely as the comet needs
+ *  at perihelion; Integrator::Block only refines the comet's step.
+ */
+static void BM_EccentricOrbit(benchmark::State& state, Universe::Integrator scheme)
+{
+    const double sunMass = 1.98892e30;
+    const double perihelion = 0.1 * 149597870700.0;
+    const double eccentricity = 0.9;
+    const double axis = perihelion / (1 - eccentricity);
+    const double period
+        = 2 * std::acos(-1.0) * std::sqrt(axis * axis * axis / (Universe::G * sunMass));
+    const vector2 start = makeVector2(perihelion, 0);
+    const auto steps = static_cast<int>(state.range(0));
+    double error = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setIntegrator(scheme);
+        makeRings(64);
+        Object* comet = ObjectFactory::makeObject("comet", 1e15, start,
+            makeVector2(0, std::sqrt(Universe::G * sunMass * (1 + eccentricity) / perihelion)));
+        state.ResumeTiming();
+
+        for (int step = 0; step < steps; ++step) {
+            univ->stepSimulation(period / steps);
+        }
+
+        state.PauseTiming();
+        error = (comet->getPosition() - start).norm();
+        univ.reset();
+        state.ResumeTiming();
+    }
+    state.counters["comet_error"] = error;
+}
+
+BENCHMARK_CAPTURE(BM_EccentricOrbit, Leapfrog, Universe::Integrator::Leapfrog)
+    ->RangeMultiplier(8)
+    ->Range(256, 16 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_EccentricOrbit, Block, Universe::Integrator::Block)
+    ->RangeMultiplier(8)
+    ->Range(256, 16 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures a hand written pairwise force sweep over a disk of
+ *  state.range(0) bodies through the virtual Object interface, as a
+ *  visitor or test would write it.
+ */
+static void BM_PairwiseObjects(benchmark::State& state)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0;
+        for (Object* lhs : *univ) {
+            for (Object* rhs : *univ) {
+                sum += lhs->getForce(*rhs)[0];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+BENCHMARK(BM_PairwiseObjects)->Arg(1 << 10);
+
+/**
+ *  Measures the same sweep as BM_PairwiseObjects through BodyRefs.
+ */
+static void BM_PairwiseBodyRefs(benchmark::State& state)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    const auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        double sum = 0;
+        for (uint32_t lhs = 0; lhs < count; ++lhs) {
+            BodyRef body = univ->getBody(lhs);
+            for (uint32_t rhs = 0; rhs < count; ++rhs) {
+                double fx = 0;
+                double fy = 0;
+                body.addForce(univ->getBody(rhs), fx, fy);
+                sum += fx;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+BENCHMARK(BM_PairwiseBodyRefs)->Arg(1 << 10);
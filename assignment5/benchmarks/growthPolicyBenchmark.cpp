@@ -0,0 +1,73 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "ArrayList.h"
+#include "GrowthPolicy.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+/**
+ *  Measures appending state.range(0) copies of value to an ArrayList
+ *  grown with the Growth policy, and reports the memory it costs:
+ *
+ *  - bytes: the size of the final buffer,
+ *  - unused: the share of that buffer holding no element,
+ *  - reallocs: the number of times the buffer grew,
+ *  - peak: the most memory held at once, counting the old and the new
+ *    buffer while elements are relocated. That is exact for elements that
+ *    are not trivially copyable and an upper bound for the others, whose
+ *    buffers realloc may extend in place.
+ */
+template <typename T, typename Growth>
+static void runGrowth(benchmark::State& state, const T& value)
+{
+    const auto count = static_cast<uint32_t>(state.range(0));
+    uint32_t capacity = 0;
+    uint32_t reallocations = 0;
+    size_t peak = 0;
+    for (auto _ : state) {
+        ArrayList<T, Growth> list;
+        capacity = 0;
+        reallocations = 0;
+        peak = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t grown = list.add(value);
+            if (grown != capacity) {
+                peak = std::max(peak, (size_t(grown) + capacity) * sizeof(T));
+                capacity = grown;
+                ++reallocations;
+            }
+        }
+        benchmark::DoNotOptimize(list[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes"] = double(capacity) * sizeof(T);
+    state.counters["unused"] = 1 - double(count) / capacity;
+    state.counters["reallocs"] = reallocations;
+    state.counters["peak"] = double(peak);
+}
+
+/**
+ *  Appends doubles, which are trivially copyable and grown with realloc.
+ */
+template <typename Growth> static void BM_GrowthDoubles(benchmark::State& state)
+{
+    runGrowth<double, Growth>(state, 1.0);
+}
+
+/**
+ *  Appends strings too long for the small string buffer, which are moved
+ *  into every new buffer one at a time.
+ */
+template <typename Growth> static void BM_GrowthStrings(benchmark::State& state)
+{
+    runGrowth<std::string, Growth>(state, std::string(64, 'x'));
+}
+
+// Counts just past a power of two are the worst case for doubling
+BENCHMARK_TEMPLATE(BM_GrowthDoubles, DoublingGrowth)->Arg(1000)->Arg(1100000)->Arg(5000000);
+BENCHMARK_TEMPLATE(BM_GrowthDoubles, HalfGrowth)->Arg(1000)->Arg(1100000)->Arg(5000000);
+BENCHMARK_TEMPLATE(BM_GrowthDoubles, PageGrowth<>)->Arg(1000)->Arg(1100000)->Arg(5000000);
+BENCHMARK_TEMPLATE(BM_GrowthStrings, DoublingGrowth)->Arg(1000)->Arg(140000);
+BENCHMARK_TEMPLATE(BM_GrowthStrings, HalfGrowth)->Arg(1000)->Arg(140000);
+BENCHMARK_TEMPLATE(BM_GrowthStrings, PageGrowth<>)->Arg(1000)->Arg(140000);
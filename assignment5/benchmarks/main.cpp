@@ -0,0 +1,31 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    // Unless told otherwise, also write the results as JSON so that runs
+    // of different builds can be compared
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOut = false;
+    for (int i = 1; i < argc; ++i) {
+        hasOut = hasOut || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    char out[] = "--benchmark_out=benchmarks.json";
+    char format[] = "--benchmark_out_format=json";
+    if (!hasOut) {
+        args.push_back(out);
+        args.push_back(format);
+    }
+    args.push_back(nullptr);
+    int count = static_cast<int>(args.size()) - 1;
+
+    // Run the registered benchmarks
+    ::benchmark::Initialize(&count, args.data());
+    if (::benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,56 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./benchmarkHelper.h"
+#include "Parser.h"
+#include "Universe.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <memory>
+
+/**
+ *  Measures Parser::loadFile() on a scene of state.range(0) bodies,
+ *  including registering them with the Universe. Releasing the Universe
+ *  is not timed.
+ */
+static void BM_LoadFile(benchmark::State& state)
+{
+    const char* filename = "parserBenchmark.txt";
+    writeScene(filename, static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        Parser parser;
+        parser.loadFile(filename);
+        state.PauseTiming();
+        univ.reset();
+        state.ResumeTiming();
+    }
+    std::remove(filename);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_LoadFile)->RangeMultiplier(8)->Range(8, 1 << 18)->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures Parser::loadFile() on a scene of state.range(0) bodies
+ *  parsed by state.range(1) threads.
+ */
+static void BM_LoadFileThreads(benchmark::State& state)
+{
+    const char* filename = "parserBenchmark.txt";
+    writeScene(filename, static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        Parser parser;
+        parser.setThreadCount(static_cast<unsigned>(state.range(1)));
+        parser.loadFile(filename);
+        state.PauseTiming();
+        univ.reset();
+        state.ResumeTiming();
+    }
+    std::remove(filename);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_LoadFileThreads)
+    ->ArgsProduct({ { 1 << 18 }, { 1, 2, 4, 8 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
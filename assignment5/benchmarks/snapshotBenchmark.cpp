@@ -0,0 +1,112 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./benchmarkHelper.h"
+#include "Object.h"
+#include "Universe.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+/**
+ *  Measures getSnapshot() over a disk of state.range(0) bodies. Releasing
+ *  the copies is not timed.
+ */
+static void BM_GetSnapshot(benchmark::State& state)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        ArrayList<Object*> snapshot = univ->getSnapshot();
+        state.PauseTiming();
+        for (auto object : snapshot) {
+            delete object;
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_GetSnapshot)->RangeMultiplier(8)->Range(2, 100000);
+
+/**
+ *  Measures Universe::save() of a disk of state.range(0) bodies.
+ */
+static void BM_SaveSnapshot(benchmark::State& state)
+{
+    const char* filename = "snapshotBenchmark.bin";
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        univ->save(filename);
+    }
+    std::remove(filename);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SaveSnapshot)->RangeMultiplier(8)->Range(8, 1 << 18)->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures Universe::load() of a snapshot of state.range(0) bodies, the
+ *  binary counterpart of BM_LoadFile.
+ */
+static void BM_LoadSnapshot(benchmark::State& state)
+{
+    const char* filename = "snapshotBenchmark.bin";
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    univ->save(filename);
+    for (auto _ : state) {
+        univ->load(filename);
+    }
+    std::remove(filename);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_LoadSnapshot)->RangeMultiplier(8)->Range(8, 1 << 18)->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures one brute-force step over a disk of state.range(0) bodies with
+ *  a checkpoint due every step, so the cost of handing state to the I/O
+ *  thread shows against BM_StepSimulation/BruteForce.
+ */
+static void BM_CheckpointedStep(benchmark::State& state)
+{
+    const std::string prefix = "checkpointBenchmark";
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    univ->setCheckpointing(prefix, 1, 1);
+    for (auto _ : state) {
+        univ->stepSimulation(1);
+    }
+    univ->stopCheckpointing();
+    for (uint64_t step : Checkpointer::list(prefix)) {
+        std::remove(Checkpointer::pathFor(prefix, step).c_str());
+    }
+}
+
+BENCHMARK(BM_CheckpointedStep)
+    ->RangeMultiplier(8)
+    ->Range(8, 4 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures one brute-force step over a disk of state.range(0) bodies
+ *  recording a trajectory frame every step, to compare against
+ *  BM_StepSimulation/BruteForce, and reports the frames the recorder had
+ *  to drop because the writer thread fell behind.
+ */
+static void BM_RecordedStep(benchmark::State& state)
+{
+    const char* filename = "trajectoryBenchmark.bin";
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    univ->setTrajectoryRecording(filename, 1);
+    for (auto _ : state) {
+        univ->stepSimulation(1);
+    }
+    state.counters["dropped"] = static_cast<double>(univ->getDroppedFrames());
+    univ->stopTrajectoryRecording();
+    std::remove(filename);
+}
+
+BENCHMARK(BM_RecordedStep)->RangeMultiplier(8)->Range(8, 4 << 10)->Unit(benchmark::kMillisecond);
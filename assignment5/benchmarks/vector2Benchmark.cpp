@@ -0,0 +1,50 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./benchmarkHelper.h"
+#include "vector2.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+/**
+ *  Measures the vector2 operations of one Euler update, a = f / m,
+ *  x += v dt and v += a dt, over state.range(0) vectors.
+ */
+static void BM_Vector2Update(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<vector2> pos(count, makeVector2(1.5e11, -2e10));
+    std::vector<vector2> vel(count, makeVector2(-3e3, 2.9e4));
+    std::vector<vector2> force(count, makeVector2(3.5e22, 1e21));
+    const double mass = 5.9742e24;
+    const double dt = 1;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            vector2 accel = force[i] / mass;
+            pos[i] += vel[i] * dt;
+            vel[i] += accel * dt;
+        }
+        benchmark::DoNotOptimize(pos.data());
+        benchmark::DoNotOptimize(vel.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Vector2Update)->Arg(1 << 10)->Arg(1 << 16);
+
+/**
+ *  Measures norm() and normalize() over state.range(0) vectors.
+ */
+static void BM_Vector2Normalize(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<vector2> vectors(count, makeVector2(3, 4));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const vector2& v : vectors) {
+            sum += v.normalize().dot(v) + v.norm();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Vector2Normalize)->Arg(1 << 10)->Arg(1 << 16);
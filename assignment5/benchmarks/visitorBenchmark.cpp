@@ -0,0 +1,67 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./benchmarkHelper.h"
+#include "Object.h"
+#include "Universe.h"
+#include "Visitor.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace {
+
+/**
+ *  Sums the momentum of the bodies through the per Object Visitor
+ *  interface, paying a virtual accept() and visit() per body.
+ */
+class ObjectMomentumVisitor : public Visitor {
+public:
+    void visit(Object& object) override
+    {
+        momentum += object.getVelocity() * object.getMass();
+    }
+
+    vector2 momentum;
+};
+
+} // namespace
+
+/**
+ *  Measures a momentum sum over a disk of state.range(0) bodies visited
+ *  one Object at a time.
+ */
+static void BM_VisitObjects(benchmark::State& state)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        ObjectMomentumVisitor visitor;
+        for (Object* object : *univ) {
+            object->accept(visitor);
+        }
+        benchmark::DoNotOptimize(visitor.momentum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_VisitObjects)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+/**
+ *  Measures the same sum with MomentumVisitor and Universe::visitAll()
+ *  over state.range(1) threads.
+ */
+static void BM_VisitAll(benchmark::State& state)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setThreadCount(static_cast<unsigned>(state.range(1)));
+    makeDisk(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        MomentumVisitor visitor;
+        univ->visitAll(visitor);
+        benchmark::DoNotOptimize(visitor.getMomentum());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_VisitAll)
+    ->ArgsProduct({ { 1 << 20 }, { 1, 2, 4 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
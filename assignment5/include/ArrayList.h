@@ -3,9 +3,11 @@
 #ifndef ARRAYLIST_H
 #define ARRAYLIST_H
 
-#include "ScopedArray.h"
+#include "GrowthPolicy.h"
+#include "ScopedBuffer.h"
 #include <cstdint>
 #include <iterator>
+#include <type_traits>
 
 // Forward declarations
 template <typename T> class ArrayListIterator;
@@ -20,16 +22,31 @@ template <typename T> class ArrayListConstIterator;
  * in a contiguous block of memory. This class assumes that the
  * parametrized type has a default and a copy constructor, an
  * assignment operator, and a destructor, the last of which never
- * throws an exception. For simplicity, destructors of the objects
- * stored in the ArrayList are not guaranteed to be called until the
- * ArrayList object's destructor is triggered.
+ * throws an exception.
+ *
+ * The buffer is allocated uninitialized and only the first size()
+ * slots hold constructed elements, so growing never default-constructs
+ * spare capacity and removing an element destroys it. Elements are
+ * moved into a new buffer when their move constructor cannot throw and
+ * copied otherwise, which keeps the old buffer intact until the new
+ * one is complete. Trivially copyable elements, such as pointers and
+ * numbers, are shifted with memmove and grown with realloc instead.
+ *
+ * Growth is the policy from GrowthPolicy.h that picks the capacity to
+ * grow to, doubling by default; HalfGrowth or PageGrowth trade more
+ * reallocations for less unused capacity. Size is the unsigned type of
+ * sizes, capacities and indices. The default uint32_t caps a list at
+ * 4G elements; uint64_t lifts that for one more word per list.
  */
 
-template <typename T> class ArrayList {
+template <typename T, typename Growth = DoublingGrowth, typename Size = uint32_t> class ArrayList {
+    static_assert(std::is_unsigned_v<Size>, "the size type must be an unsigned integer");
+
 public:
     // Useful traits
     typedef ArrayListIterator<T> iterator;
     typedef ArrayListConstIterator<T> const_iterator;
+    typedef Size size_type;
 
     /**
      * Creates an ArrayList of size 0.
@@ -42,54 +59,132 @@ public:
      * @param size size of the ArrayList to create
      * @param value value used to fill the ArrayList
      */
-    explicit ArrayList(uint32_t size, const T& value = T());
+    explicit ArrayList(Size size, const T& value = T());
 
     /**
      * Creates a deep copy of the provided ArrayList
      * @param src ArrayList to copy
      */
-    ArrayList(const ArrayList<T>& src);
+    ArrayList(const ArrayList& src);
+
+    /**
+     * Creates an ArrayList holding copies of the elements of [first, last),
+     * in order, allocating the buffer once when the range can be measured.
+     * @param first the beginning of the range to copy
+     * @param last the end of the range to copy
+     */
+    template <typename InputIt,
+        typename = typename std::iterator_traits<InputIt>::iterator_category>
+    ArrayList(InputIt first, InputIt last);
 
     /**
      * Performs move constructor semantics on the provided ArrayList
      * @param src ArrayList to move
      */
-    ArrayList(ArrayList<T>&& src) noexcept;
+    ArrayList(ArrayList&& src) noexcept;
+
+    /**
+     * Destroys the elements and releases the buffer.
+     */
+    ~ArrayList();
 
     /**
      * Makes *this a deep copy of the provided ArrayList.
      * @param src ArrayList to copy
      * @return *this for chaining
      */
-    ArrayList<T>& operator=(const ArrayList<T>& src);
+    ArrayList& operator=(const ArrayList& src);
 
     /**
      * Performs move assignment semantics on the provided ArrayList.
      * @param src ArrayList to move
      * @return *this for chaining
      */
-    ArrayList<T>& operator=(ArrayList<T>&& src) noexcept;
+    ArrayList& operator=(ArrayList&& src) noexcept;
 
     /**
      * Adds the provided element to the end of this ArrayList.  If the
-     * ArrayList needs to be enlarged, double the capacity from the
-     * current capacity, or go from zero to one.
+     * ArrayList needs to be enlarged, the capacity grows as chosen by the
+     * Growth policy.
      * @param value value to add
      * @return total array capacity
      */
-    uint32_t add(const T& value);
+    Size add(const T& value);
 
     /**
      * Inserts the specified value into this ArrayList at the specified index.
      * The object is inserted before any previous element at the specified
-     * location. If the ArrayList needs to be enlarged, continue doubling the capacity
-     * from the current capacity until the desired index is in range.  Fill any empty
+     * location. If the ArrayList needs to be enlarged, the capacity grows as chosen by
+     * the Growth policy until the desired index is in range.  Fill any empty
      * elements up to the new element's index with the default value for the template type.
      * @param index location at which to insert the new element
      * @param value the element to insert
      * @return total array capacity
      */
-    uint32_t add(uint32_t index, const T& value);
+    Size add(Size index, const T& value);
+
+    /**
+     * Moves the provided element to the end of this ArrayList, growing it
+     * like add(const T&).
+     * @param value value to move in
+     * @return total array capacity
+     */
+    Size add(T&& value);
+
+    /**
+     * Constructs a new element from args directly in the buffer at the
+     * specified index, before any previous element at that location. The
+     * ArrayList grows, and gaps are filled, like add(index, value).
+     * @param index location at which to construct the new element
+     * @param args arguments forwarded to a constructor of the template type
+     * @return a T & to the new element
+     */
+    template <typename... Args> T& emplace(Size index, Args&&... args);
+
+    /**
+     * Constructs a new element from args directly in the buffer at the end
+     * of this ArrayList.
+     * @param args arguments forwarded to a constructor of the template type
+     * @return a T & to the new element
+     */
+    template <typename... Args> T& emplace_back(Args&&... args);
+
+    /**
+     * Enlarges the buffer to hold at least capacity elements, so that
+     * adding up to that many never reallocates. Never shrinks the buffer
+     * or changes the size.
+     * @param capacity the number of elements to make room for
+     */
+    void reserve(Size capacity);
+
+    /**
+     * Shrinks the buffer to exactly size() elements.
+     */
+    void shrink_to_fit();
+
+    /**
+     * Inserts copies of the elements of [first, last) into this ArrayList
+     * at the specified index, before any previous element at that location.
+     * The capacity grows at most once and the following elements are
+     * shifted once, by the length of the range; single-pass input ranges
+     * are gathered first to measure them. Gaps are filled like
+     * add(index, value). The range must not refer to elements of this
+     * ArrayList.
+     * @param index location at which to insert the new elements
+     * @param first the beginning of the range to copy
+     * @param last the end of the range to copy
+     * @return total array capacity
+     */
+    template <typename InputIt> Size insert(Size index, InputIt first, InputIt last);
+
+    /**
+     * Appends copies of the elements of [first, last) to the end of this
+     * ArrayList, like insert(size(), first, last).
+     * @param first the beginning of the range to copy
+     * @param last the end of the range to copy
+     * @return total array capacity
+     */
+    template <typename InputIt> Size append(InputIt first, InputIt last);
 
     /**
      * Clears this ArrayList, leaving it empty.
@@ -103,7 +198,7 @@ public:
      * @param index the desired location
      * @return a const T & to the desired element.
      */
-    const T& get(uint32_t index) const;
+    const T& get(Size index) const;
 
     /**
      * Returns a T & to the element stored at the specified index.
@@ -112,7 +207,7 @@ public:
      * @param index the desired location
      * @return a T & to the desired element.
      */
-    T& get(uint32_t index);
+    T& get(Size index);
 
     /**
      * Returns a T & to the element stored at the specified index.
@@ -121,7 +216,7 @@ public:
      * @param index the desired location
      * @return a T & to the desired element.
      */
-    T& operator[](uint32_t index);
+    T& operator[](Size index);
 
     /**
      * Returns a const T & to the element stored at the specified index.
@@ -129,7 +224,7 @@ public:
      * @param index the desired location
      * @return a const T & to the desired element.
      */
-    const T& operator[](uint32_t index) const;
+    const T& operator[](Size index) const;
 
     /**
      * Empty check.
@@ -163,12 +258,12 @@ public:
     const_iterator end() const;
 
     /**
-     * Removes an element at the specified location from this ArrayList and
-     * returns it. Elements following index are shifted down. If index is out of
-     * range, std::out_of_range is thrown with index as its message.
+     * Removes an element at the specified location from this ArrayList.
+     * Elements following index are shifted down. If index is out of range,
+     * std::out_of_range is thrown with index as its message.
      * @param index the desired location
      */
-    void remove(uint32_t index);
+    void remove(Size index);
 
     /**
      * Sets the element at the desired location to the specified value. If index
@@ -176,36 +271,101 @@ public:
      * @param index the location to change
      * @param value the new value of the specified element.
      */
-    void set(uint32_t index, const T& value);
+    void set(Size index, const T& value);
 
     /**
      * Returns the size of this ArrayList.
      * @return the size of this ArrayList.
      */
-    [[nodiscard]] uint32_t size() const;
+    [[nodiscard]] Size size() const;
+
+    /**
+     * Returns the number of elements the buffer can hold without growing.
+     * @return the capacity of this ArrayList.
+     */
+    [[nodiscard]] Size capacity() const;
 
     /**
      * Perform an exception-safe swap of the contents of *this with
      * src.
      */
-    void swap(ArrayList<T>& src) noexcept;
+    void swap(ArrayList& src) noexcept;
 
 private:
     /**
-     * Wrapper around our physical buffer.
+     * Wrapper around our physical buffer. Only [0, mSize) is constructed.
      */
-    ScopedArray<T> mArray;
+    ScopedBuffer<T> mArray;
 
     /**
      * The logical size of this ArrayList.
      */
-    uint32_t mSize;
+    Size mSize;
 
     /**
      * The maximum capacity of the physical buffer.
      */
-    uint32_t mCapacity;
-    void check_range(const uint32_t& index) const;
+    Size mCapacity;
+    void check_range(const Size& index) const;
+
+    /**
+     * Constructs [first, last) into the uninitialized storage at dest,
+     * moving when that cannot throw and copying otherwise. If a copy
+     * throws, whatever was constructed is destroyed and [first, last) is
+     * left as it was.
+     * @return the end of the constructed range
+     */
+    static T* relocate(T* first, T* last, T* dest);
+
+    /**
+     * Copy-constructs count elements starting at first into the
+     * uninitialized storage at dest, with a single memcpy when T is
+     * trivially copyable and first points into contiguous storage of T.
+     * Nothing is left constructed if a copy throws.
+     */
+    template <typename ForwardIt>
+    static void copyConstruct(ForwardIt first, Size count, T* dest);
+
+    /**
+     * Moves the constructed elements of [first, last) to dest one at a
+     * time, leaving the source slots that are not overwritten
+     * uninitialized. Only used when moving cannot throw.
+     */
+    static void shift(T* first, T* last, T* dest) noexcept;
+
+    /**
+     * Returns the capacity to grow to so that size elements fit, as chosen
+     * by the Growth policy.
+     */
+    [[nodiscard]] Size grownCapacity(Size size) const;
+
+    /**
+     * Relocates the elements into a new buffer of the provided capacity,
+     * leaving *this untouched if anything throws.
+     */
+    void reallocate(Size capacity);
+
+    /**
+     * Performs emplace(index, args...) into a new buffer of the provided
+     * capacity, leaving *this untouched if anything throws.
+     */
+    template <typename... Args>
+    void reallocateAndEmplace(Size capacity, Size index, Args&&... args);
+
+    /**
+     * Inserts count copies starting at first at the specified index,
+     * shifting in place when the buffer is large enough and moving cannot
+     * throw, and through a new buffer otherwise. *this is left untouched
+     * if anything throws.
+     */
+    template <typename ForwardIt>
+    void insertCopies(Size index, ForwardIt first, Size count);
+
+    /**
+     * Performs remove(index) by relocating the other elements into a new
+     * buffer, for types whose move operations may throw.
+     */
+    void reallocateAndRemove(Size index);
 };
 
 #include "../src/ArrayList.cpp"
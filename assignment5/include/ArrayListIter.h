@@ -134,7 +134,7 @@ private:
      */
     explicit ArrayListIterator(T* ptr);
 
-    friend class ArrayList<T>;
+    template <typename, typename, typename> friend class ArrayList;
     template <typename X>
     friend ArrayListIterator<X> operator+(int offset, const ArrayListIterator<X>& iter);
 
@@ -263,7 +263,7 @@ private:
      */
     explicit ArrayListConstIterator(const T* ptr);
 
-    friend class ArrayList<T>;
+    template <typename, typename, typename> friend class ArrayList;
     template <typename X>
     friend ArrayListConstIterator<X> operator+(
         const int32_t& offset, const ArrayListConstIterator<X>& iter);
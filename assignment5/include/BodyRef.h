@@ -0,0 +1,137 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef BODYREF_H
+#define BODYREF_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "BodyStore.h"
+#include "Gravity.h"
+#include "SymbolTable.h"
+#include "vector2.h"
+
+/**
+ *  A non-virtual handle onto the body in one slot of a BodyStore, with
+ *  the accessors of Object. It is final and every member is defined
+ *  here, so a loop over BodyRefs compiles down to loads and stores on
+ *  the packed columns, where the same loop over Objects pays a virtual
+ *  call per accessor. Object remains the interface for visitors and
+ *  composites; registered Objects implement their accessors through a
+ *  BodyRef.
+ *
+ *  A BodyRef is only valid while the store does not grow or shrink.
+ */
+class BodyRef final {
+public:
+    BodyRef(BodyStore& store, uint32_t slot) noexcept
+        : store(&store)
+        , slot(slot)
+    {
+    }
+
+    [[nodiscard]] uint32_t getSlot() const noexcept
+    {
+        return slot;
+    }
+
+    [[nodiscard]] double getMass() const noexcept
+    {
+        return store->mass[slot];
+    }
+
+    [[nodiscard]] uint32_t getNameId() const noexcept
+    {
+        return store->names[slot];
+    }
+
+    [[nodiscard]] std::string_view getName() const noexcept
+    {
+        return symbols::lookup(store->names[slot]);
+    }
+
+    /**
+     *  Components of the position in meters and of the velocity in
+     *  meters/second.
+     */
+    [[nodiscard]] double getX() const noexcept
+    {
+        return store->x[slot];
+    }
+
+    [[nodiscard]] double getY() const noexcept
+    {
+        return store->y[slot];
+    }
+
+    [[nodiscard]] double getVX() const noexcept
+    {
+        return store->vx[slot];
+    }
+
+    [[nodiscard]] double getVY() const noexcept
+    {
+        return store->vy[slot];
+    }
+
+    /**
+     *  The position and velocity as vectors. vector2 itself is compiled
+     *  out of line, so hot loops should prefer the components.
+     */
+    [[nodiscard]] vector2 getPosition() const noexcept
+    {
+        vector2 pos;
+        pos[0] = store->x[slot];
+        pos[1] = store->y[slot];
+        return pos;
+    }
+
+    [[nodiscard]] vector2 getVelocity() const noexcept
+    {
+        vector2 vel;
+        vel[0] = store->vx[slot];
+        vel[1] = store->vy[slot];
+        return vel;
+    }
+
+    /**
+     *  Adds the force experienced by this body due to rhs to fx and fy,
+     *  exactly as Object::getForce computes it.
+     */
+    void addForce(const BodyRef& rhs, double& fx, double& fy) const noexcept
+    {
+        gravity::addPairForce(
+            getX(), getY(), getMass(), rhs.getX(), rhs.getY(), rhs.getMass(), fx, fy);
+    }
+
+    /**
+     *  Sets the position, counting as a change of the store's positions.
+     */
+    void setPosition(double x, double y) noexcept
+    {
+        store->x[slot] = x;
+        store->y[slot] = y;
+        ++store->revision;
+    }
+
+    void setPosition(const vector2& pos) noexcept
+    {
+        setPosition(pos[0], pos[1]);
+    }
+
+    void setVelocity(double vx, double vy) noexcept
+    {
+        store->vx[slot] = vx;
+        store->vy[slot] = vy;
+    }
+
+    void setVelocity(const vector2& vel) noexcept
+    {
+        setVelocity(vel[0], vel[1]);
+    }
+
+private:
+    BodyStore* store;
+    uint32_t slot;
+};
+
+#endif // BODYREF_H
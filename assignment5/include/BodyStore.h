@@ -0,0 +1,120 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef BODYSTORE_H
+#define BODYSTORE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "vector2.h"
+
+/**
+ *  Structure-of-arrays storage for the state of every body registered
+ *  with the Universe. The hot per-body quantities live in contiguous
+ *  columns indexed by slot so that force loops stream through memory
+ *  instead of chasing Object pointers; names are only needed for
+ *  reporting and are kept in a separate cold table.
+ *
+ *  Positions and velocities are double buffered: a simulation step reads
+ *  the front columns, writes the back columns and then calls flip(). The
+ *  buffers are sized when bodies are added, so stepping never allocates.
+ */
+struct BodyStore {
+    /**
+     *  Appends a body and returns its slot.
+     */
+    uint32_t add(std::string_view name, double m, const vector2& pos, const vector2& vel);
+
+    /**
+     *  Appends a body named by an id returned from symbols::intern() and
+     *  returns its slot.
+     */
+    uint32_t add(uint32_t nameId, double m, const vector2& pos, const vector2& vel);
+
+    /**
+     *  Makes room for count bodies in total, so that adding up to that
+     *  many does not reallocate the columns.
+     */
+    void reserve(uint32_t count);
+
+    /**
+     *  Returns the number of bodies.
+     */
+    [[nodiscard]] uint32_t size() const noexcept;
+
+    /**
+     *  Removes every body. Capacity is retained.
+     */
+    void clear() noexcept;
+
+    /**
+     *  Exchanges the front and back position and velocity columns. Only
+     *  the column handles are swapped; no state is copied.
+     */
+    void flip() noexcept;
+
+    /**
+     *  Returns the name of the body in slot.
+     */
+    [[nodiscard]] std::string_view getName(uint32_t slot) const noexcept;
+
+    /**
+     *  Returns the position of the body in slot as a vector.
+     */
+    [[nodiscard]] vector2 getPosition(uint32_t slot) const noexcept;
+
+    /**
+     *  Returns the velocity of the body in slot as a vector.
+     */
+    [[nodiscard]] vector2 getVelocity(uint32_t slot) const noexcept;
+
+    /**
+     *  Sets the position of the body in slot.
+     */
+    void setPosition(uint32_t slot, const vector2& pos) noexcept;
+
+    /**
+     *  Sets the velocity of the body in slot.
+     */
+    void setVelocity(uint32_t slot, const vector2& vel) noexcept;
+
+    /**
+     *  Position columns in meters.
+     */
+    std::vector<double> x;
+    std::vector<double> y;
+
+    /**
+     *  Velocity columns in meters/second.
+     */
+    std::vector<double> vx;
+    std::vector<double> vy;
+
+    /**
+     *  Back buffers for the position and velocity columns. Their content
+     *  is unspecified between steps.
+     */
+    std::vector<double> nextX;
+    std::vector<double> nextY;
+    std::vector<double> nextVX;
+    std::vector<double> nextVY;
+
+    /**
+     *  Mass column in kilograms.
+     */
+    std::vector<double> mass;
+
+    /**
+     *  Cold side table of names, as ids into the symbol table.
+     */
+    std::vector<uint32_t> names;
+
+    /**
+     *  Incremented by add(), clear() and setPosition(), so that values
+     *  derived from the positions can tell whether they are still
+     *  current. flip() does not count as a change.
+     */
+    uint64_t revision = 0;
+};
+
+#endif // BODYSTORE_H
@@ -0,0 +1,147 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BodyStore.h"
+
+/**
+ *  Writes snapshot files of a running simulation on a background thread.
+ *
+ *  The simulation calls onStep() after every step. Every interval-th step
+ *  the state is copied into a pending buffer, which the I/O thread picks
+ *  up and saves as prefix.<step>.snap, keeping only the newest retention
+ *  files of this run. The simulation thread only ever waits for the I/O
+ *  thread to swap buffers, never for the disk: if a checkpoint is still
+ *  pending when the next one is due, the newer state replaces it and the
+ *  older one is counted as skipped.
+ */
+class Checkpointer {
+public:
+    /**
+     *  Starts the I/O thread for a simulation at step start. prefix may
+     *  include a directory, which must exist. Checkpoints of prefix up to
+     *  start are taken to be the history of this run, such as the one it
+     *  resumed from, and are pruned with the new ones. Later ones can only
+     *  be left from another run and are deleted, so that they are never
+     *  resumed from. Throws std::invalid_argument if interval or retention
+     *  is 0.
+     */
+    Checkpointer(std::string prefix, uint64_t interval, unsigned retention, uint64_t start);
+
+    /**
+     *  Writes the pending checkpoint, if any, and stops the I/O thread.
+     *  Write errors that were not reported by flush() are dropped.
+     */
+    ~Checkpointer();
+
+    /*
+     * Deny access to copy-constructor and assignment operator
+     */
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    /**
+     *  Hands the state after the provided step to the I/O thread if a
+     *  checkpoint is due.
+     */
+    void onStep(uint64_t step, const BodyStore& bodies);
+
+    /**
+     *  Blocks until every checkpoint handed over so far is on disk. Throws
+     *  the first error the I/O thread ran into since the last flush().
+     */
+    void flush();
+
+    /**
+     *  Returns the number of checkpoints written.
+     */
+    [[nodiscard]] uint64_t getWritten() const;
+
+    /**
+     *  Returns the number of checkpoints replaced by a newer one before
+     *  they could be written.
+     */
+    [[nodiscard]] uint64_t getSkipped() const;
+
+    /**
+     *  Returns the file a checkpoint of the provided step is written to.
+     */
+    static std::string pathFor(const std::string& prefix, uint64_t step);
+
+    /**
+     *  Returns the steps of the checkpoint files that exist for prefix,
+     *  in increasing order.
+     */
+    static std::vector<uint64_t> list(const std::string& prefix);
+
+private:
+    void writerLoop();
+
+    /**
+     *  Records the checkpoint of step as kept and deletes all but the
+     *  newest retention kept checkpoints. The first call adopts the files
+     *  up to start, which a checkpointer being replaced may still have
+     *  been writing when this one was created.
+     */
+    void prune(uint64_t step);
+
+    const std::string prefix;
+    const uint64_t interval;
+    const unsigned retention;
+
+    mutable std::mutex mutex;
+
+    /**
+     *  Signals the I/O thread that a checkpoint is pending or that it
+     *  should stop.
+     */
+    std::condition_variable wake;
+
+    /**
+     *  Signals flush() that the I/O thread ran out of work.
+     */
+    std::condition_variable idle;
+
+    /**
+     *  State handed over by onStep() and the state being written. The two
+     *  are swapped, so neither is reallocated once sized.
+     */
+    BodyStore pending;
+    uint64_t pendingStep = 0;
+    bool hasPending = false;
+    BodyStore writing;
+    bool busy = false;
+
+    /**
+     *  The step the simulation was at when checkpointing started.
+     */
+    const uint64_t start;
+
+    /**
+     *  Steps of the checkpoints of this run still on disk, in increasing
+     *  order, gathered by the first prune(). Only used by the I/O thread.
+     */
+    std::vector<uint64_t> kept;
+    bool adopted = false;
+
+    bool stopping = false;
+    uint64_t written = 0;
+    uint64_t skipped = 0;
+
+    /**
+     *  First write error not yet reported by flush().
+     */
+    std::exception_ptr error;
+
+    std::thread writer;
+};
+
+#endif // CHECKPOINTER_H
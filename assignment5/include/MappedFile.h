@@ -0,0 +1,46 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+/**
+ *  A read-only memory mapping of a whole file, released when the object
+ *  goes out of scope. Reading through data() lets the kernel page the
+ *  file in on demand and avoids copying it into user buffers.
+ */
+class MappedFile {
+public:
+    /**
+     *  Maps the named file. Throws std::system_error if it cannot be
+     *  opened or mapped.
+     */
+    explicit MappedFile(const char* filename);
+
+    /**
+     *  Unmaps the file.
+     */
+    ~MappedFile();
+
+    /*
+     * Deny access to copy-constructor and assignment operator
+     */
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     *  Returns the first byte of the file, or nullptr if it is empty.
+     */
+    [[nodiscard]] const char* data() const noexcept;
+
+    /**
+     *  Returns the size of the file in bytes.
+     */
+    [[nodiscard]] size_t size() const noexcept;
+
+private:
+    const char* bytes;
+    size_t length;
+};
+
+#endif // MAPPEDFILE_H
@@ -2,17 +2,30 @@
 #ifndef OBJECT_H
 #define OBJECT_H
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 
 #include "vector2.h"
 
 // Forward declaration.
+class CompositeObject;
+class ObjectPool;
 class Visitor;
 class ObjectFactory;
+class Universe;
+struct BodyStore;
 
 /**
  *  Representation of objects suitable for use in the simulation. For
  *  this assignment, this will be the only allowable type.
+ *
+ *  Once registered with the Universe an Object acts as a proxy: its
+ *  accessors read and write the Universe's packed BodyStore instead of
+ *  its own members. Copies made through clone() are detached again and
+ *  carry their own state.
+ *
+ *  Objects are allocated from a slab pool of Object sized blocks instead
+ *  of the global heap, see getPool().
  */
 class Object {
 public:
@@ -38,9 +51,15 @@ public:
     virtual double getMass() const noexcept;
 
     /**
-     *  Returns the name.
+     *  Returns the name. The view stays valid until the program exits.
      */
-    virtual std::string getName() const noexcept;
+    virtual std::string_view getName() const noexcept;
+
+    /**
+     *  Returns the id of the name in the symbol table. Objects have the
+     *  same id exactly when they have the same name.
+     */
+    uint32_t getNameId() const noexcept;
 
     /**
      *  Returns the position vector.
@@ -69,6 +88,11 @@ public:
      */
     virtual void setVelocity(const vector2& vel);
 
+    /**
+     *  Returns the composite this object is a member of, or nullptr.
+     */
+    CompositeObject* getParent() const noexcept;
+
     /**
      *  Returns true if this object is member-wise equal to rhs.
      */
@@ -79,19 +103,49 @@ public:
      */
     bool operator!=(const Object& rhs) const;
 
+    /**
+     *  Allocates an Object from the pool. Larger subclasses fall back to
+     *  the global allocator.
+     */
+    static void* operator new(size_t size);
+
+    /**
+     *  Returns an Object allocated by operator new to where it came from.
+     */
+    static void operator delete(void* ptr, size_t size) noexcept;
+
+    /**
+     *  Returns the pool Objects are allocated from, for its counters.
+     */
+    static const ObjectPool& getPool();
+
 private:
+    friend class CompositeObject;
     friend class ObjectFactory;
+    friend class Universe;
 
     /**
      * Initializes an object with the provided properties. Should only
      * be called by the ObjectFactory.
      */
-    Object(const std::string& name, double mass, const vector2& pos, const vector2& vel);
+    Object(std::string_view name, double mass, const vector2& pos, const vector2& vel);
 
     /**
-     *  Name of the object.
+     *  Initializes an object named by an id returned from
+     *  symbols::intern().
      */
-    std::string name;
+    Object(uint32_t nameId, double mass, const vector2& pos, const vector2& vel);
+
+    /**
+     *  Turns this object into a proxy for the body in slot of store, or
+     *  detaches it when store is nullptr. Only called by the Universe.
+     */
+    void bind(BodyStore* store, uint32_t slot) noexcept;
+
+    /**
+     *  Id of the name of the object in the symbol table.
+     */
+    uint32_t name;
 
     /**
      *  Mass of the object in kilograms.
@@ -107,6 +161,21 @@ private:
      *  Velocity vector of the object in meters/second.
      */
     vector2 velocity;
+
+    /**
+     *  Storage this object is a proxy for, or nullptr while detached.
+     */
+    BodyStore* store;
+
+    /**
+     *  Index of this object within store.
+     */
+    uint32_t slot;
+
+    /**
+     *  Composite this object is a member of, or nullptr.
+     */
+    CompositeObject* parent;
 };
 
 #endif // OBJECT_H
@@ -4,7 +4,11 @@
 
 #include "vector2.h"
 
+#include <cstdint>
+#include <string_view>
+
 // Forward declaration.
+class CompositeObject;
 class Object;
 
 /**
@@ -22,8 +26,29 @@ public:
      * parameters. Default values of zero will be assigned to everything
      * except for name.  Also adds the object to the singleton Universe.
      */
-    static Object* makeObject(std::string name, double mass = 0, const vector2& pos = vector2(),
-        const vector2& vel = vector2());
+    static Object* makeObject(std::string_view name, double mass = 0,
+        const vector2& pos = vector2(), const vector2& vel = vector2());
+
+    /**
+     * Creates an object named by an id returned from symbols::intern()
+     * and adds it to the singleton Universe.
+     */
+    static Object* makeObject(
+        uint32_t nameId, double mass, const vector2& pos, const vector2& vel);
+
+    /**
+     * Creates an empty composite with the provided name and registers it
+     * with the singleton Universe. Members are added with
+     * CompositeObject::add().
+     */
+    static CompositeObject* makeComposite(std::string_view name);
+
+    /**
+     * Makes room in the singleton Universe for count more objects, so
+     * that a following run of makeObject calls does not keep growing its
+     * storage.
+     */
+    static void reserve(uint32_t count);
 };
 
 #endif // OBJECT_FACTORY_H
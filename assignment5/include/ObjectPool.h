@@ -0,0 +1,91 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ *  A fixed block size allocator carving blocks out of slabs of
+ *  blocksPerSlab blocks each. Freed blocks go onto a free list and are
+ *  handed out again before a new slab is allocated, so once a run has
+ *  reached its peak number of live blocks the pool never calls the
+ *  global allocator again, and blocks of one slab stay next to each
+ *  other in memory however often they are recycled. Slabs are only
+ *  returned when the pool is destroyed.
+ *
+ *  The counters are meant for tests and benchmarks, in the spirit of
+ *  AllocationTracker.
+ */
+class ObjectPool {
+public:
+    /**
+     *  Creates an empty pool of blocks of at least blockSize bytes,
+     *  aligned like the global operator new.
+     */
+    ObjectPool(size_t blockSize, size_t blocksPerSlab);
+
+    /**
+     *  Returns every slab to the global allocator.
+     */
+    ~ObjectPool();
+
+    /*
+     * Deny access to copy-constructor and assignment operator
+     */
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     *  Returns a block, from a new slab if no freed block is left.
+     *  Throws std::bad_alloc if a slab cannot be allocated.
+     */
+    void* allocate();
+
+    /**
+     *  Puts a block returned by allocate() back on the free list.
+     */
+    void deallocate(void* block) noexcept;
+
+    /**
+     *  Returns the size of a block in bytes.
+     */
+    [[nodiscard]] size_t getBlockSize() const noexcept;
+
+    /**
+     *  Returns the number of blocks handed out and not yet freed.
+     */
+    [[nodiscard]] uint64_t getCount() const;
+
+    /**
+     *  Returns the number of slabs allocated from the global allocator.
+     */
+    [[nodiscard]] uint64_t getSlabCount() const;
+
+    /**
+     *  Returns the number of calls to allocate() so far.
+     */
+    [[nodiscard]] uint64_t getAllocationCount() const;
+
+private:
+    /**
+     *  A free block holds the link to the next one.
+     */
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    const size_t blockSize;
+    const size_t blocksPerSlab;
+
+    mutable std::mutex mutex;
+    FreeBlock* freeList = nullptr;
+    std::vector<std::unique_ptr<char[]>> slabs;
+    uint64_t count = 0;
+    uint64_t allocations = 0;
+};
+
+#endif // OBJECTPOOL_H
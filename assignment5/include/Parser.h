@@ -2,6 +2,38 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "vector2.h"
+
+/**
+ * Thrown by the Parser when a line of a script is malformed. Lines and
+ * columns are counted from 1; the column points at the offending token,
+ * or just past the end of the line when a field is missing.
+ */
+class ParseError : public std::runtime_error {
+public:
+    ParseError(uint32_t line, uint32_t column, const std::string& message);
+
+    /**
+     * Returns the line the error was found on.
+     */
+    [[nodiscard]] uint32_t getLine() const noexcept;
+
+    /**
+     * Returns the column the error was found at.
+     */
+    [[nodiscard]] uint32_t getColumn() const noexcept;
+
+private:
+    uint32_t line;
+    uint32_t column;
+};
+
 /**
  * Class responsible for loading in custom setup scripts and
  * configuring the Universe appropriately.
@@ -10,17 +42,77 @@ class Parser {
 public:
     /**
      *  Loads the script file and configures the Universe. Consult the
-     *  assignment README.md for the syntax of the scripts.
+     *  assignment README.md for the syntax of the scripts. The file is
+     *  memory mapped and scanned in place. Throws std::system_error if
+     *  the file cannot be read and ParseError if a line is malformed, in
+     *  which case the bodies on the lines before it have been added.
      */
     void loadFile(const char* filename);
 
+    /**
+     *  Loads a script held in memory, exactly as loadFile() would.
+     */
+    void load(const char* data, size_t size);
+
+    /**
+     *  Sets the number of threads that parse a script, the calling
+     *  thread included. One (the default) parses serially; zero uses
+     *  every hardware thread. Scripts are split at line boundaries into
+     *  chunks that are parsed concurrently, after which the bodies are
+     *  added to the Universe in file order, so the first line is still
+     *  the sun. Errors are reported exactly as when parsing serially.
+     */
+    void setThreadCount(unsigned threads);
+
+    /**
+     *  Returns the number of threads that parse a script.
+     */
+    [[nodiscard]] unsigned getThreadCount() const;
+
 private:
-    const char* delims()
-    {
-        return "{}[], ";
-    }
+    /**
+     * The fields of one line. name points into the script.
+     */
+    struct Record {
+        std::string_view name;
+        double mass;
+        vector2 pos;
+        vector2 vel;
+    };
 
-    double getDouble();
+    /**
+     * Parses one line, without its line break, into record. Returns false
+     * if the line is blank and throws ParseError if it is malformed.
+     */
+    static bool parseLine(std::string_view text, uint32_t line, Record& record);
+
+    /**
+     * Parses the number in token, which starts at column of line.
+     */
+    static double parseNumber(std::string_view token, uint32_t line, uint32_t column);
+
+    /**
+     * Parses every line in [begin, end), the first of which is line
+     * firstLine, and calls sink(record) for each body in order.
+     */
+    template <typename Sink>
+    static void parseLines(const char* begin, const char* end, uint32_t firstLine, Sink&& sink);
+
+    /**
+     * Adds a body for each of count records, interning their names in
+     * one batch.
+     */
+    static void addRecords(const Record* records, size_t count);
+
+    /**
+     * Parses the script in the provided number of chunks concurrently.
+     */
+    void loadChunks(const char* data, size_t size, unsigned chunks);
+
+    /**
+     * Number of threads that parse a script.
+     */
+    unsigned threads = 1;
 };
 
 #endif // PARSER_H
@@ -0,0 +1,119 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef QUADTREE_H
+#define QUADTREE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "vector2.h"
+
+/**
+ *  A Barnes-Hut quadtree over a set of point masses. A cell whose size
+ *  over distance ratio falls below the opening angle theta is treated
+ *  as a single point mass at its center of mass; all other cells are
+ *  opened and resolved to their children. A theta of zero opens every
+ *  cell and therefore reproduces the exact pairwise sum.
+ *
+ *  The tree does not own the body state. The arrays handed to build()
+ *  must stay alive and unchanged until the next call to build(). Node
+ *  storage is retained between builds, so rebuilding the tree every
+ *  step does not allocate once the node pool has grown large enough.
+ */
+class QuadTree {
+public:
+    /**
+     *  Creates an empty tree with the provided opening angle.
+     */
+    explicit QuadTree(double theta = 0.5);
+
+    /**
+     *  Sets the opening angle. Must not be negative.
+     */
+    void setOpeningAngle(double theta);
+
+    /**
+     *  Returns the opening angle.
+     */
+    [[nodiscard]] double getOpeningAngle() const noexcept;
+
+    /**
+     *  Rebuilds the tree over count bodies whose positions and masses
+     *  are given by the x, y and mass arrays.
+     */
+    void build(const double* x, const double* y, const double* mass, uint32_t count);
+
+    /**
+     *  Calculates the approximate force experienced by the body at
+     *  index as the sum of the forces exerted by all other bodies.
+     *  Bodies sharing the exact position of index exert no force.
+     */
+    [[nodiscard]] vector2 getForce(uint32_t index) const;
+
+    /**
+     *  Returns the number of nodes in the current tree.
+     */
+    [[nodiscard]] uint32_t nodeCount() const noexcept;
+
+private:
+    /**
+     *  A square cell of the tree. Children are allocated as a block of
+     *  four, so a cell only stores the index of its first child; zero
+     *  marks a leaf since the root can never be a child. Leaves keep a
+     *  singly linked list of their bodies through next.
+     */
+    struct Node {
+        double centerX;
+        double centerY;
+        double half;
+        double mass;
+        double comX;
+        double comY;
+        uint32_t firstChild;
+        uint32_t firstBody;
+        uint32_t count;
+    };
+
+    /**
+     *  Deepest level at which a cell is still subdivided. Bodies which
+     *  end up in the same cell at this depth share a leaf.
+     */
+    static const uint32_t MAX_DEPTH = 48;
+
+    /**
+     *  Sentinel used to terminate the per leaf body lists.
+     */
+    static const uint32_t NONE = UINT32_MAX;
+
+    void insert(uint32_t body);
+
+    void subdivide(uint32_t node);
+
+    [[nodiscard]] uint32_t quadrant(const Node& node, uint32_t body) const;
+
+    void summarize();
+
+    /**
+     *  The opening angle.
+     */
+    double theta;
+
+    /**
+     *  Body state the tree was built over.
+     */
+    const double* x;
+    const double* y;
+    const double* mass;
+    uint32_t count;
+
+    /**
+     *  Node pool. The root is always nodes[0].
+     */
+    std::vector<Node> nodes;
+
+    /**
+     *  Next body in the same leaf, or NONE.
+     */
+    std::vector<uint32_t> next;
+};
+
+#endif // QUADTREE_H
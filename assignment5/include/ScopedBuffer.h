@@ -0,0 +1,67 @@
+// @author G. Hemingway, copyright 2020 - All rights reserved
+
+#ifndef SCOPEDBUFFER_H
+#define SCOPEDBUFFER_H
+
+#include <cstddef>
+
+/**
+ * The uninitialized counterpart of ScopedArray: owns raw storage for a
+ * number of objects of type T without constructing or destroying any of
+ * them. Whoever places objects into the buffer must destroy them before
+ * it is released. Storage comes from std::malloc, so T must not need
+ * more than the fundamental alignment.
+ */
+template <typename T> class ScopedBuffer {
+public:
+    /*
+     * Deny access to copy-constructor and assignment operator
+     */
+    ScopedBuffer(const ScopedBuffer<T>& rhs) = delete;
+    ScopedBuffer<T>& operator=(const ScopedBuffer<T>& rhs) = delete;
+
+    /**
+     * Allocates room for count objects, or nothing if count is zero.
+     * Throws std::bad_alloc if the storage cannot be allocated.
+     * @param count Number of objects to make room for
+     */
+    explicit ScopedBuffer(size_t count = 0);
+
+    /**
+     * Frees the storage without destroying anything in it
+     */
+    ~ScopedBuffer();
+
+    /**
+     * Getter for the underlying storage
+     * @return Pointer to the first object's storage, or nullptr
+     */
+    T* get() const;
+
+    /**
+     * Resizes the storage to count objects with std::realloc, which may
+     * extend it in place. The first objects up to the smaller of the two
+     * sizes are kept byte for byte, so T must be trivially copyable. If
+     * the storage cannot be resized, std::bad_alloc is thrown and the old
+     * storage is kept.
+     * @param count Number of objects to make room for
+     */
+    void resize(size_t count);
+
+    /**
+     * Swap the underlying pointers
+     * @param rhs ScopedBuffer to swap pointers with
+     */
+    void swap(ScopedBuffer& rhs) noexcept;
+
+private:
+    /**
+     * Pointer to the storage
+     */
+    T* buffer;
+};
+
+// Include the class definition
+#include "../src/ScopedBuffer.cpp"
+
+#endif // SCOPEDBUFFER_H
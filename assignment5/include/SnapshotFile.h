@@ -0,0 +1,57 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef SNAPSHOTFILE_H
+#define SNAPSHOTFILE_H
+
+#include <cstdint>
+
+struct BodyStore;
+
+/**
+ *  Binary snapshot files holding the complete state of a BodyStore.
+ *
+ *  A file is a fixed header followed by the packed columns and a string
+ *  table, all in host byte order:
+ *
+ *      char     magic[8]            "NBODYSNP"
+ *      uint32_t version             VERSION
+ *      uint32_t byteOrder           BYTE_ORDER_MARK as written by the host
+ *      uint64_t count               number of bodies
+ *      uint64_t nameBytes           size of the string table
+ *      double   mass[count], x[count], y[count], vx[count], vy[count]
+ *      uint64_t nameEnd[count]      end of each name in the string table
+ *      char     names[nameBytes]    names, back to back, not terminated
+ *
+ *  Every column starts on an 8 byte boundary, so loading is a handful of
+ *  block copies out of a memory mapping and nothing is parsed.
+ */
+namespace snapshot {
+
+/**
+ *  Format version written by save() and the only one load() accepts.
+ */
+constexpr uint32_t VERSION = 1;
+
+/**
+ *  Written as a uint32_t so that files from a host of the other byte
+ *  order are recognized.
+ */
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ *  Writes bodies to filename. The data goes to filename.tmp first, which
+ *  is then renamed over filename, so readers never see a partial file.
+ *  Throws std::system_error if the file cannot be written.
+ */
+void save(const BodyStore& bodies, const char* filename);
+
+/**
+ *  Replaces the content of bodies with the snapshot in filename. Throws
+ *  std::system_error if the file cannot be read and std::runtime_error
+ *  if it is not a complete snapshot of this version and byte order; in
+ *  either case bodies is left unchanged.
+ */
+void load(const char* filename, BodyStore& bodies);
+
+} // namespace snapshot
+
+#endif // SNAPSHOTFILE_H
@@ -0,0 +1,51 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ *  A process wide table of interned strings. Every distinct string is
+ *  stored once and identified by a 32-bit id, so that code holding names
+ *  only copies and compares integers. Interned strings are never
+ *  released, which suits object names: a simulation has few distinct
+ *  ones and keeps reusing them.
+ */
+namespace symbols {
+
+/**
+ *  Id of the empty string.
+ */
+constexpr uint32_t EMPTY = 0;
+
+/**
+ *  Returns the id of text, adding it to the table if it is new. Equal
+ *  strings always get the same id. Safe to call from any thread. Throws
+ *  std::length_error if the table is full.
+ */
+uint32_t intern(std::string_view text);
+
+/**
+ *  Interns count strings into ids, the same as calling intern() on each
+ *  but considerably faster for long lists of names.
+ */
+void intern(const std::string_view* texts, size_t count, uint32_t* ids);
+
+/**
+ *  Returns the string with the provided id, which must have been returned
+ *  by intern(). The view stays valid until the program exits. Takes no
+ *  lock.
+ */
+std::string_view lookup(uint32_t id) noexcept;
+
+/**
+ *  Returns the number of distinct strings interned so far, the empty
+ *  string included.
+ */
+uint32_t size() noexcept;
+
+} // namespace symbols
+
+#endif // SYMBOLTABLE_H
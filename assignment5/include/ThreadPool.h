@@ -0,0 +1,124 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ *  A fixed set of worker threads that is created once and reused for
+ *  every parallel loop, so that running a loop in parallel costs a wake
+ *  up instead of a thread creation.
+ *
+ *  parallelFor() uses static chunking: [0, count) is split into size()
+ *  contiguous chunks and chunk w always runs as worker w. The calling
+ *  thread takes part as worker 0. Since the partition only depends on
+ *  count and size(), per worker results can be reduced in a
+ *  deterministic order.
+ */
+class ThreadPool {
+public:
+    /**
+     *  Creates a pool with the provided number of participants, the
+     *  calling thread included. A pool of size one never starts a thread.
+     */
+    explicit ThreadPool(unsigned threads);
+
+    /**
+     *  Stops and joins every worker.
+     */
+    ~ThreadPool();
+
+    /*
+     * Deny access to copy-constructor and assignment operator
+     */
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     *  Returns the number of participants, the calling thread included.
+     */
+    [[nodiscard]] unsigned size() const noexcept;
+
+    /**
+     *  Calls body(begin, end, worker) once for every worker's chunk of
+     *  [0, count) and returns when all of them are done. If any call
+     *  throws, the first exception is rethrown here after the loop has
+     *  finished. Must not be called concurrently or from within body.
+     */
+    template <typename Body> void parallelFor(uint32_t count, Body&& body);
+
+    /**
+     *  Returns the first index of the chunk of [0, count) owned by worker
+     *  in a pool of the provided size.
+     */
+    static uint32_t chunkBegin(uint32_t count, unsigned worker, unsigned size) noexcept;
+
+private:
+    /**
+     *  Type erased loop body, so dispatching a loop never allocates.
+     */
+    typedef void (*Trampoline)(void* body, uint32_t begin, uint32_t end, unsigned worker);
+
+    void run(uint32_t count, Trampoline trampoline, void* body);
+
+    void runChunk(unsigned worker) noexcept;
+
+    void workerLoop(unsigned worker);
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+
+    /**
+     *  Signals workers that a new loop is available or that they should stop.
+     */
+    std::condition_variable wake;
+
+    /**
+     *  Signals the caller that the last worker finished its chunk.
+     */
+    std::condition_variable done;
+
+    /**
+     *  Incremented for every loop so workers can tell new work from old.
+     */
+    uint64_t generation;
+
+    /**
+     *  Number of workers still running the current loop.
+     */
+    unsigned pending;
+
+    bool stopping;
+
+    /**
+     *  The loop currently being run.
+     */
+    uint32_t count;
+    Trampoline trampoline;
+    void* body;
+
+    /**
+     *  First exception thrown by the current loop.
+     */
+    std::exception_ptr error;
+};
+
+template <typename Body> void ThreadPool::parallelFor(uint32_t count, Body&& body)
+{
+    typedef typename std::remove_reference<Body>::type Callable;
+    run(
+        count,
+        [](void* ptr, uint32_t begin, uint32_t end, unsigned worker) {
+            (*static_cast<Callable*>(ptr))(begin, end, worker);
+        },
+        const_cast<void*>(static_cast<const void*>(&body)));
+}
+
+#endif // THREADPOOL_H
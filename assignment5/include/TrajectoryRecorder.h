@@ -0,0 +1,162 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#ifndef TRAJECTORYRECORDER_H
+#define TRAJECTORYRECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BodyStore.h"
+
+/**
+ *  Appends sampled positions and velocities of a running simulation to a
+ *  columnar binary trajectory file, in host byte order:
+ *
+ *      char     magic[8]            "NBODYTRJ"
+ *      uint32_t version             VERSION
+ *      uint32_t byteOrder           BYTE_ORDER_MARK as written by the host
+ *
+ *  followed by one frame per sample:
+ *
+ *      uint64_t step                steps taken when the sample was made
+ *      uint64_t count               number of bodies
+ *      double   x[count], y[count], vx[count], vy[count]
+ *
+ *  The simulation thread copies every frame into a fixed size ring
+ *  buffer it shares with a writer thread, and the writer thread streams
+ *  the buffer to the file. Neither side takes a lock: the simulation
+ *  only publishes how far it has written and the writer how far it has
+ *  read. When a frame does not fit in the free part of the buffer it is
+ *  dropped and counted instead of stalling the simulation, so the
+ *  buffer should hold a few frames' worth of the disk's slowest moments.
+ */
+class TrajectoryRecorder {
+public:
+    /**
+     *  Format version written by the recorder and the only one read()
+     *  accepts.
+     */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     *  Written as a uint32_t so that files from a host of the other byte
+     *  order are recognized.
+     */
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    /**
+     *  One frame read back by read().
+     */
+    struct Frame {
+        uint64_t step;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> vx;
+        std::vector<double> vy;
+    };
+
+    /**
+     *  Creates filename, writes the file header and starts the writer
+     *  thread. bufferBytes is rounded up to a power of two. Throws
+     *  std::invalid_argument if interval or bufferBytes is 0 and
+     *  std::system_error if the file cannot be created.
+     */
+    TrajectoryRecorder(const char* filename, uint64_t interval, size_t bufferBytes);
+
+    /**
+     *  Writes every buffered frame and stops the writer thread. Write
+     *  errors that were not reported by flush() are dropped.
+     */
+    ~TrajectoryRecorder();
+
+    /*
+     * Deny access to copy-constructor and assignment operator
+     */
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    /**
+     *  Buffers the state after the provided step if a sample is due.
+     *  Must only be called from one thread at a time.
+     */
+    void onStep(uint64_t step, const BodyStore& bodies);
+
+    /**
+     *  Blocks until every frame buffered so far has been handed to the
+     *  operating system. Throws the first error the writer thread ran
+     *  into since the last flush().
+     */
+    void flush();
+
+    /**
+     *  Returns the number of frames buffered.
+     */
+    [[nodiscard]] uint64_t getRecorded() const noexcept;
+
+    /**
+     *  Returns the number of frames dropped because the buffer was full.
+     */
+    [[nodiscard]] uint64_t getDropped() const noexcept;
+
+    /**
+     *  Returns every frame of a trajectory file. Throws std::system_error
+     *  if the file cannot be read and std::runtime_error if it is not a
+     *  trajectory of this version and byte order. A partial frame at the
+     *  end, as left by a process that died while writing, is ignored.
+     */
+    static std::vector<Frame> read(const char* filename);
+
+private:
+    void writerLoop();
+
+    /**
+     *  Copies bytes into the ring starting at the absolute offset at,
+     *  wrapping around its end.
+     */
+    void put(uint64_t at, const void* data, size_t bytes) noexcept;
+
+    /**
+     *  Writes [from, to) of the ring to the file.
+     */
+    void drain(uint64_t from, uint64_t to);
+
+    const uint64_t interval;
+    std::ofstream out;
+
+    std::unique_ptr<char[]> ring;
+    const uint64_t mask;
+
+    /**
+     *  Absolute offsets of the end of the last published frame and of the
+     *  last byte the writer thread consumed. Only ever increase, so the
+     *  used part of the ring is head - tail.
+     */
+    alignas(64) std::atomic<uint64_t> head { 0 };
+    alignas(64) std::atomic<uint64_t> tail { 0 };
+
+    /**
+     *  Offset up to which the file has been flushed.
+     */
+    std::atomic<uint64_t> flushed { 0 };
+
+    std::atomic<uint64_t> recorded { 0 };
+    std::atomic<uint64_t> dropped { 0 };
+    std::atomic<bool> stopping { false };
+
+    /**
+     *  First write error not yet reported by flush(). Only touched on the
+     *  error path and by flush().
+     */
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    std::thread writer;
+};
+
+#endif // TRAJECTORYRECORDER_H
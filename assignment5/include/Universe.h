@@ -3,8 +3,21 @@
 #define UNIVERSE_H
 
 #include "ArrayList.h"
+#include "BodyRef.h"
+#include "BodyStore.h"
+#include "Checkpointer.h"
+#include "CompositeTree.h"
+#include "Gravity.h"
+#include "GravityKernel.h"
+#include "QuadTree.h"
+#include "ThreadPool.h"
+#include "TrajectoryRecorder.h"
+
+#include <memory>
 
 // Forward declaration
+class BatchVisitor;
+class CompositeObject;
 class Object;
 class ObjectFactory;
 
@@ -12,6 +25,11 @@ class ObjectFactory;
  *  A singleton class representing the Universe. For this assignment,
  *  the first object added to the Universe will be considered
  *  unmovable and so its position should not be changed.
+ *
+ *  The state of every registered Object is kept in a packed BodyStore
+ *  and the registered Objects act as proxies onto it, so iterating the
+ *  Universe through begin() and end() observes the live state while the
+ *  simulation itself only touches contiguous arrays.
  */
 class Universe {
 public:
@@ -19,7 +37,44 @@ public:
     typedef ArrayList<Object*>::iterator iterator;
     typedef ArrayList<Object*>::const_iterator const_iterator;
 
-    static constexpr double G = 6.67428e-11;
+    static constexpr double G = gravity::G;
+
+    /**
+     *  Strategies available for computing the net force on each body.
+     *  BruteForce sums every pair exactly in O(N^2); BarnesHut builds a
+     *  QuadTree every step and approximates distant groups of bodies by
+     *  their center of mass in O(N log N); Symmetric evaluates each pair
+     *  only once and applies the equal and opposite force to both bodies,
+     *  halving the pairwise work of BruteForce. Composite follows the
+     *  hierarchy of the composites made by ObjectFactory::makeComposite(),
+     *  treating a composite that is far from a body, by the opening
+     *  angle, as a point mass at its center of mass and resolving it to
+     *  its members otherwise; bodies outside every composite are summed
+     *  exactly, see CompositeTree.
+     */
+    enum class ForceMethod { BruteForce, BarnesHut, Symmetric, Composite };
+
+    /**
+     *  Schemes available for advancing the bodies by one step.
+     *
+     *  Euler moves every body with its velocity at the start of the step
+     *  and is first order. Leapfrog is the kick-drift-kick form of
+     *  velocity Verlet: second order, symplectic and one force evaluation
+     *  per step, since the accelerations at the end of a step are kept
+     *  for the start of the next. Yoshida4 chains three leapfrog steps
+     *  into a fourth order symplectic step for three evaluations. RK4 is
+     *  the classical fourth order Runge-Kutta method with four
+     *  evaluations; it is more accurate per step than Yoshida4 but, not
+     *  being symplectic, its energy error grows steadily over many orbits.
+     *
+     *  Block gives every body its own leapfrog step, timeSec / 2^k for a
+     *  level k between 0 and getMaxBlockLevel(), chosen from how fast the
+     *  body's acceleration changes. A body is only kicked, and its force
+     *  only computed, when its own step is due, so a close encounter
+     *  refines the step of the bodies involved instead of all of them.
+     *  Every body is synchronized again at the end of stepSimulation().
+     */
+    enum class Integrator { Euler, Leapfrog, Yoshida4, RK4, Block };
 
     /**
      *  Returns the one and only instance of the Universe.
@@ -62,8 +117,8 @@ public:
 
     /**
      * Returns a container of copies of all the Objects registered with
-     * the Universe. This should be used as the source of data for
-     * computing the next step in the simulation
+     * the Universe. The copies are detached: changing them does not
+     * affect the Universe until they are handed to swap().
      */
     [[nodiscard]] ArrayList<Object*> getSnapshot() const;
 
@@ -71,16 +126,264 @@ public:
      * Advances the simulation by the provided time step. For this
      * assignment, you must assume that the first registered object is a
      * "sun" and its position should not be affected by any of the other
-     * objects.
+     * objects. All bodies are updated simultaneously from the state at
+     * the start of the step, using the selected Integrator. Steps do not
+     * allocate once the first step has run.
      */
     void stepSimulation(const double& timeSec);
 
+    /**
+     * Advances the simulation by steps steps of timeSec, the same as
+     * calling stepSimulation() that many times.
+     */
+    void run(uint64_t steps, double timeSec);
+
+    /**
+     * Advances the simulation by steps steps of timeSec. After every
+     * sampleInterval-th step the positions are written to samples, as by
+     * getPositions(), and observer(step, samples) is called with the
+     * number of steps taken so far. samples must hold two doubles per
+     * body. A sampleInterval of zero never samples. Nothing is copied or
+     * allocated between samples, so a long run costs the same as its
+     * steps.
+     */
+    template <typename Observer>
+    void run(uint64_t steps, double timeSec, uint64_t sampleInterval, double* samples,
+        Observer&& observer);
+
+    /**
+     * Writes the position of every body to positions as x0, y0, x1, y1,
+     * ... in iteration order. positions must hold two doubles per body.
+     */
+    void getPositions(double* positions) const;
+
     /**
      * Swaps the contents of the provided container with the Universe's
-     * Object store and releases the old Objects.
+     * Object store and releases the old Objects. The registered
+     * composites, which group the old Objects, are released too. Throws
+     * std::invalid_argument and changes nothing if any provided Object
+     * is a member of a composite.
      */
     void swap(ArrayList<Object*>& snapshot);
 
+    /**
+     * Writes the name, mass, position and velocity of every registered
+     * Object to a binary snapshot file, as described in SnapshotFile.h.
+     * Throws std::system_error if the file cannot be written.
+     */
+    void save(const char* filename) const;
+
+    /**
+     * Replaces the registered Objects with the bodies of a snapshot
+     * written by save() and releases the old ones. Throws
+     * std::system_error if the file cannot be read and
+     * std::runtime_error if it is not a valid snapshot, in which case the
+     * Universe is left unchanged. Snapshots hold no composites, so the
+     * registered ones are released.
+     */
+    void load(const char* filename);
+
+    /**
+     * Writes a checkpoint every interval steps, keeping the newest
+     * retention of them, as described in Checkpointer.h. The state is
+     * copied at the end of the step and saved on a background thread,
+     * so stepping never waits for the disk. Checkpoints of prefix past the
+     * current step are deleted, so a later resume() cannot pick up those of
+     * another run. Replaces any previous checkpointing, after writing its
+     * last checkpoint. Throws std::invalid_argument if interval or
+     * retention is 0 and then keeps the previous checkpointing.
+     */
+    void setCheckpointing(const std::string& prefix, uint64_t interval, unsigned retention = 2);
+
+    /**
+     * Writes the last pending checkpoint and stops checkpointing.
+     */
+    void stopCheckpointing();
+
+    /**
+     * Blocks until every checkpoint due so far is on disk. Throws the
+     * first error met while writing one since the last call.
+     */
+    void flushCheckpoints();
+
+    /**
+     * Loads the newest readable checkpoint for prefix, sets the step
+     * count to its step and returns it. Checkpoints that fail to load
+     * are skipped. Returns 0 and leaves the Universe unchanged if there
+     * is none.
+     */
+    uint64_t resume(const std::string& prefix);
+
+    /**
+     * Returns the number of steps taken since the Universe was created
+     * or since the checkpoint it resumed from.
+     */
+    [[nodiscard]] uint64_t getStepCount() const;
+
+    /**
+     * Records the positions and velocities of every body to a
+     * trajectory file every interval steps, as described in
+     * TrajectoryRecorder.h, starting with the current state if the step
+     * count is a multiple of interval. Frames go through a ring buffer of
+     * bufferBytes drained by a background thread, so stepping never
+     * waits for the disk; frames that do not fit are dropped. Replaces
+     * any previous recording, after writing its buffered frames. Throws
+     * the first error the previous recording ran into, like
+     * flushTrajectory(), std::invalid_argument if interval or bufferBytes
+     * is 0 and std::system_error if the file cannot be created, and then
+     * keeps the previous recording.
+     */
+    void setTrajectoryRecording(const char* filename, uint64_t interval,
+        size_t bufferBytes = size_t(64) << 20);
+
+    /**
+     * Writes the buffered frames and stops recording.
+     */
+    void stopTrajectoryRecording();
+
+    /**
+     * Blocks until every frame recorded so far has been written. Throws
+     * the first error met while writing since the last call.
+     */
+    void flushTrajectory();
+
+    /**
+     * Returns the number of frames of the current recording dropped
+     * because its buffer was full.
+     */
+    [[nodiscard]] uint64_t getDroppedFrames() const;
+
+    /**
+     * Selects the strategy used by stepSimulation() to compute forces.
+     * Defaults to ForceMethod::BruteForce.
+     */
+    void setForceMethod(ForceMethod method);
+
+    /**
+     * Returns the strategy used by stepSimulation() to compute forces.
+     */
+    [[nodiscard]] ForceMethod getForceMethod() const;
+
+    /**
+     * Sets the opening angle of ForceMethod::BarnesHut and
+     * ForceMethod::Composite. Smaller values are more accurate and
+     * slower; zero reproduces the brute-force sum.
+     */
+    void setOpeningAngle(double theta);
+
+    /**
+     * Returns the opening angle.
+     */
+    [[nodiscard]] double getOpeningAngle() const;
+
+    /**
+     * Sets the number of threads stepSimulation() spreads the bodies
+     * over, the calling thread included. One (the default) steps
+     * serially; zero uses every hardware thread. The worker pool is
+     * created here, once, and reused by every step. Results are bitwise
+     * identical for every thread count, except with ForceMethod::Symmetric
+     * where every thread accumulates into its own force columns and the
+     * reduction order depends on the number of threads.
+     */
+    void setThreadCount(unsigned threads);
+
+    /**
+     * Returns the number of threads used by stepSimulation().
+     */
+    [[nodiscard]] unsigned getThreadCount() const;
+
+    /**
+     * Selects the instruction set of the brute-force pairwise kernel.
+     * Defaults to the widest level the CPU supports, as reported by
+     * gravity::detectSimdLevel(); SimdLevel::Scalar reproduces
+     * Object::getForce exactly. Throws std::invalid_argument if the CPU
+     * does not support the level.
+     */
+    void setSimdLevel(gravity::SimdLevel level);
+
+    /**
+     * Returns the instruction set of the brute-force pairwise kernel.
+     */
+    [[nodiscard]] gravity::SimdLevel getSimdLevel() const;
+
+    /**
+     * Selects the scheme used by stepSimulation() to advance the bodies.
+     * Defaults to Integrator::Euler.
+     */
+    void setIntegrator(Integrator scheme);
+
+    /**
+     * Returns the scheme used by stepSimulation() to advance the bodies.
+     */
+    [[nodiscard]] Integrator getIntegrator() const;
+
+    /**
+     * Sets the accuracy parameter eta of Integrator::Block. A body's step
+     * is the largest block step not exceeding eta times the shorter of
+     * |v| / |a| and |a| / |da/dt|, the latter being measured over its
+     * previous step. Defaults to 0.01. Throws std::invalid_argument if
+     * eta is not positive.
+     */
+    void setBlockAccuracy(double eta);
+
+    /**
+     * Returns the accuracy parameter of Integrator::Block.
+     */
+    [[nodiscard]] double getBlockAccuracy() const;
+
+    /**
+     * Sets the deepest level of Integrator::Block, so that the shortest
+     * step is timeSec / 2^levels. Defaults to 16. Throws
+     * std::invalid_argument if levels is larger than 32.
+     */
+    void setMaxBlockLevel(unsigned levels);
+
+    /**
+     * Returns the deepest level of Integrator::Block.
+     */
+    [[nodiscard]] unsigned getMaxBlockLevel() const;
+
+    /**
+     * Returns the level every body used for its last block step, by
+     * slot. Slot 0, the sun, is always at level 0. Empty until the first
+     * Integrator::Block step.
+     */
+    [[nodiscard]] const std::vector<unsigned>& getBlockLevels() const;
+
+    /**
+     * Returns the total mechanical energy in joules: the kinetic energy
+     * of every body but the sun plus the potential energy of every pair.
+     * This is the quantity a symplectic integrator keeps bounded.
+     */
+    [[nodiscard]] double getEnergy() const;
+
+    /**
+     * Returns the packed state of the registered Objects. Slot i holds
+     * the state of the i-th Object in iteration order.
+     */
+    [[nodiscard]] const BodyStore& getBodies() const;
+
+    /**
+     * Returns a non-virtual handle onto the body in slot, the i-th Object
+     * in iteration order. Reading and writing through it is the same as
+     * through the Object, but every call is inlined.
+     */
+    [[nodiscard]] BodyRef getBody(uint32_t slot);
+
+    /**
+     * Hands the packed state of every body to visitor as BodySpans. With
+     * more than one thread the bodies are split into one span per
+     * thread, visited in parallel by copies from visitor.split() and
+     * merged back into visitor in slot order.
+     */
+    void visitAll(BatchVisitor& visitor);
+
+    /**
+     * Returns the composites made by ObjectFactory::makeComposite(), in
+     * the order they were made.
+     */
+    [[nodiscard]] const ArrayList<CompositeObject*>& getComposites() const;
+
 private:
     /**
      * Private constructor. Ensures access control.
@@ -94,6 +397,39 @@ private:
      */
     Object* addObject(Object* ptr);
 
+    /**
+     * Makes room for count more Objects in the packed store.
+     */
+    void reserve(uint32_t count);
+
+    /**
+     * Registers a composite with the Universe, which will clean it up.
+     */
+    CompositeObject* addComposite(CompositeObject* ptr);
+
+    /**
+     * Marks the hierarchy of the composites as changed, so that the
+     * CompositeTree is rebuilt before it is next used.
+     */
+    void compositesChanged();
+
+    /**
+     * Deletes the registered composites.
+     */
+    void releaseComposites();
+
+    /**
+     * Describes the composites and the bodies outside them to the
+     * CompositeTree, if they changed since it was last built.
+     */
+    void buildCompositeTree();
+
+    /**
+     * Adds object and, for a composite, its members to the CompositeTree.
+     */
+    void addToCompositeTree(const Object& object);
+
+    friend class CompositeObject;
     friend class ObjectFactory;
 
     /**
@@ -101,11 +437,168 @@ private:
      */
     static void release(ArrayList<Object*>& objects);
 
+    /**
+     * Computes the net force on every body but the sun at the provided
+     * positions into forceX and forceY, using the current force method.
+     */
+    void computeForces(const double* x, const double* y);
+
+    /**
+     * ForceMethod::Symmetric part of computeForces().
+     */
+    void computeSymmetricForces(const double* x, const double* y);
+
+    /**
+     * Computes the net force on every body at the provided positions
+     * and divides it into accelX and accelY.
+     */
+    void computeAccelerations(const double* x, const double* y);
+
+    /**
+     * Copies the state of the sun into the back buffers.
+     */
+    void holdSun();
+
+    /**
+     * Integrator::Euler step.
+     */
+    void eulerStep(double timeSec);
+
+    /**
+     * Computes the new state of the bodies in [begin, end) into the back
+     * buffers from the front buffers and forceX and forceY.
+     */
+    void integrate(uint32_t begin, uint32_t end, double timeSec);
+
+    /**
+     * One kick-drift-kick leapfrog step, reusing the accelerations left
+     * by the previous one when the positions have not changed since.
+     */
+    void leapfrogStep(double timeSec);
+
+    /**
+     * Integrator::RK4 step.
+     */
+    void rk4Step(double timeSec);
+
+    /**
+     * Integrator::Block step.
+     */
+    void blockStep(double timeSec);
+
+    /**
+     * Computes the net force on the bodies listed in active at the
+     * current positions into forceX and forceY.
+     */
+    void computeActiveForces();
+
+    /**
+     * Returns the level a body of the provided time scale should use
+     * next, given that its new step starts tick ticks into the block.
+     */
+    [[nodiscard]] unsigned chooseBlockLevel(double timescale, double timeSec, uint64_t tick) const;
+
+    /**
+     * Calls body(begin, end) over [begin, end), split across the worker
+     * pool when there is one.
+     */
+    template <typename Body> void forEachBody(uint32_t begin, uint32_t end, Body&& body);
+
     /**
      * Container for pointers to the registered Objects.
      */
     ArrayList<Object*> objects;
 
+    /**
+     * Packed state of the registered Objects.
+     */
+    BodyStore bodies;
+
+    /**
+     * Strategy used to compute forces.
+     */
+    ForceMethod forceMethod = ForceMethod::BruteForce;
+
+    /**
+     * Barnes-Hut tree, rebuilt every step while forceMethod is BarnesHut.
+     */
+    QuadTree tree;
+
+    /**
+     * Registered composites, and the tree built from them for
+     * ForceMethod::Composite, valid while compositeTreeValid is set.
+     */
+    ArrayList<CompositeObject*> composites;
+    CompositeTree compositeTree;
+    bool compositeTreeValid = false;
+
+    /**
+     * Persistent workers used when more than one thread is requested.
+     */
+    std::unique_ptr<ThreadPool> pool;
+
+    /**
+     * Instruction set and matching kernel used for brute-force sums.
+     */
+    gravity::SimdLevel simdLevel = gravity::detectSimdLevel();
+    gravity::ForceKernel kernel = gravity::getForceKernel(simdLevel);
+
+    /**
+     * Scheme used to advance the bodies.
+     */
+    Integrator integrator = Integrator::Euler;
+
+    /**
+     * Net force on every body, filled by computeForces().
+     */
+    std::vector<double> forceX;
+    std::vector<double> forceY;
+
+    /**
+     * Per thread force columns for ForceMethod::Symmetric, one block of
+     * bodies.size() entries per thread.
+     */
+    std::vector<double> partialX;
+    std::vector<double> partialY;
+
+    /**
+     * Acceleration of every body, filled by computeAccelerations(). It is
+     * kept between leapfrog steps while accelValid is set and the store
+     * is still at accelRevision.
+     */
+    std::vector<double> accelX;
+    std::vector<double> accelY;
+    bool accelValid = false;
+    uint64_t accelRevision = 0;
+
+    /**
+     * Integrator::Block settings and per body state: the current level,
+     * the tick the current step ends at, and the time scale from which
+     * the next level is chosen. Bodies due at the current tick are
+     * listed in active.
+     */
+    double blockAccuracy = 0.01;
+    unsigned maxBlockLevel = 16;
+    std::vector<unsigned> blockLevels;
+    std::vector<uint64_t> blockDue;
+    std::vector<double> blockTimescale;
+    std::vector<uint32_t> active;
+
+    /**
+     * Intermediate positions and velocities for Integrator::RK4.
+     */
+    std::vector<double> stageX;
+    std::vector<double> stageY;
+    std::vector<double> stageVX;
+    std::vector<double> stageVY;
+
+    /**
+     * Steps taken, and the background writer while checkpointing.
+     */
+    uint64_t stepCount = 0;
+    std::unique_ptr<Checkpointer> checkpointer;
+    std::unique_ptr<TrajectoryRecorder> recorder;
+
     /**
      * Static pointer that ensures only a single instance of this class
      * exists.
@@ -113,4 +606,19 @@ private:
     static Universe* inst;
 };
 
+template <typename Observer>
+void Universe::run(
+    uint64_t steps, double timeSec, uint64_t sampleInterval, double* samples, Observer&& observer)
+{
+    uint64_t untilSample = sampleInterval;
+    for (uint64_t step = 1; step <= steps; ++step) {
+        stepSimulation(timeSec);
+        if (--untilSample == 0) {
+            getPositions(samples);
+            observer(step, static_cast<const double*>(samples));
+            untilSample = sampleInterval;
+        }
+    }
+}
+
 #endif // UNIVERSE_H
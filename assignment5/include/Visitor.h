@@ -2,8 +2,12 @@
 #ifndef VISITOR_H
 #define VISITOR_H
 
+#include <cstdint>
+#include <memory>
 #include <ostream>
 
+#include "vector2.h"
+
 // Forward declaration.
 class Object;
 
@@ -47,4 +51,117 @@ private:
     std::ostream& os;
 };
 
+/**
+ *  A contiguous run of bodies handed to a BatchVisitor: the slots
+ *  [begin, end) of the Universe's packed state. The columns are indexed
+ *  by slot, so body i of the span is mass[i], x[i], ... for begin <= i <
+ *  end.
+ */
+struct BodySpan {
+    uint32_t begin;
+    uint32_t end;
+    const uint32_t* names;
+    const double* mass;
+    const double* x;
+    const double* y;
+    const double* vx;
+    const double* vy;
+};
+
+/**
+ *  A visitor over the packed state of the Universe instead of its
+ *  Objects, for diagnostics that touch every body. Where a Visitor costs
+ *  a virtual accept() and a virtual visit() per body, a BatchVisitor
+ *  gets one call per span and loops over plain arrays.
+ *
+ *  Universe::visitAll() splits the bodies into one span per thread. Every
+ *  thread but the first visits a copy made by split(), and the copies
+ *  are merged back in thread order, so the result is the same for any
+ *  number of threads up to rounding.
+ */
+class BatchVisitor {
+public:
+    virtual ~BatchVisitor() = default;
+
+    /**
+     *  Visits the bodies of span, adding them to the result.
+     */
+    virtual void visit(const BodySpan& span) = 0;
+
+    /**
+     *  Returns a visitor of the same type with an empty result, for
+     *  another thread to visit its span with.
+     */
+    [[nodiscard]] virtual std::unique_ptr<BatchVisitor> split() const = 0;
+
+    /**
+     *  Adds the result of other, made by split(), to this one.
+     */
+    virtual void merge(const BatchVisitor& other) = 0;
+};
+
+/**
+ *  Sums the total mass, linear momentum and kinetic energy of the bodies.
+ */
+class MomentumVisitor : public BatchVisitor {
+public:
+    void visit(const BodySpan& span) override;
+
+    [[nodiscard]] std::unique_ptr<BatchVisitor> split() const override;
+
+    void merge(const BatchVisitor& other) override;
+
+    /**
+     *  Returns the total mass in kilograms.
+     */
+    [[nodiscard]] double getMass() const noexcept;
+
+    /**
+     *  Returns the total momentum in kilogram meters/second.
+     */
+    [[nodiscard]] vector2 getMomentum() const noexcept;
+
+    /**
+     *  Returns the total kinetic energy in joules.
+     */
+    [[nodiscard]] double getKineticEnergy() const noexcept;
+
+private:
+    double mass = 0;
+    double momentumX = 0;
+    double momentumY = 0;
+    double kineticEnergy = 0;
+};
+
+/**
+ *  Finds the smallest axis aligned box holding every body.
+ */
+class BoundsVisitor : public BatchVisitor {
+public:
+    void visit(const BodySpan& span) override;
+
+    [[nodiscard]] std::unique_ptr<BatchVisitor> split() const override;
+
+    void merge(const BatchVisitor& other) override;
+
+    /**
+     *  Returns true if no body has been visited.
+     */
+    [[nodiscard]] bool isEmpty() const noexcept;
+
+    /**
+     *  Return the lower left and upper right corners of the box. Only
+     *  meaningful unless isEmpty().
+     */
+    [[nodiscard]] vector2 getMin() const noexcept;
+    [[nodiscard]] vector2 getMax() const noexcept;
+
+private:
+    bool empty = true;
+    double minX = 0;
+    double minY = 0;
+    double maxX = 0;
+    double maxY = 0;
+};
+
 #endif // VISITOR_H
@@ -4,14 +4,20 @@
 #define ARRAYLIST_CPP
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 /**
  * Default constructor
  */
-template <typename T>
-ArrayList<T>::ArrayList()
-    : mArray(nullptr)
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>::ArrayList()
+    : mArray()
     , mSize(0)
     , mCapacity(0)
 {
@@ -23,52 +29,78 @@ ArrayList<T>::ArrayList()
  * @param size size of the ArrayList to create
  * @param value value used to fill the ArrayList
  */
-template <typename T>
-ArrayList<T>::ArrayList(uint32_t size, const T& value)
-    : mArray(new T[size])
-    , mSize(size)
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>::ArrayList(Size size, const T& value)
+    : mArray(size)
+    , mSize(0)
     , mCapacity(size)
 {
-    std::fill(begin(), end(), value);
+    std::uninitialized_fill_n(mArray.get(), size, value);
+    mSize = size;
 }
 
 /**
  * Creates a deep copy of the provided ArrayList
  * @param src ArrayList to copy
  */
-template <typename T>
-ArrayList<T>::ArrayList(const ArrayList<T>& src)
-    : mArray(new T[src.mCapacity])
-    , mSize(src.mSize)
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>::ArrayList(const ArrayList& src)
+    : mArray(src.mCapacity)
+    , mSize(0)
     , mCapacity(src.mCapacity)
 {
-    std::copy(src.begin(), src.end(), begin());
+    copyConstruct(src.mArray.get(), src.mSize, mArray.get());
+    mSize = src.mSize;
+}
+
+/**
+ * Creates an ArrayList holding copies of the elements of [first, last).
+ * @param first the beginning of the range to copy
+ * @param last the end of the range to copy
+ */
+template <typename T, typename Growth, typename Size>
+template <typename InputIt, typename>
+ArrayList<T, Growth, Size>::ArrayList(InputIt first, InputIt last)
+    : ArrayList()
+{
+    append(first, last);
 }
 
 /**
  * Performs move constructor semantics on the provided ArrayList
  * @param src ArrayList to move
  */
-template <typename T>
-ArrayList<T>::ArrayList(ArrayList<T>&& src) noexcept
-    : mArray(src.mArray.release())
-    , mSize(src.size)
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>::ArrayList(ArrayList&& src) noexcept
+    : mArray()
+    , mSize(src.mSize)
     , mCapacity(src.mCapacity)
 {
+    mArray.swap(src.mArray);
     src.mCapacity = src.mSize = 0;
 }
 
+/**
+ * Destroys the elements and releases the buffer.
+ */
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>::~ArrayList()
+{
+    std::destroy_n(mArray.get(), mSize);
+}
+
 /**
  * Makes *this a deep copy of the provided ArrayList.
  * @param src ArrayList to copy
  * @return *this for chaining
  */
-template <typename T> ArrayList<T>& ArrayList<T>::operator=(const ArrayList<T>& src)
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>& ArrayList<T, Growth, Size>::operator=(const ArrayList& src)
 {
     if (this == &src) {
         return *this;
     }
-    ArrayList<T>(src).swap(*this);
+    ArrayList(src).swap(*this);
     return *this;
 }
 
@@ -77,15 +109,13 @@ template <typename T> ArrayList<T>& ArrayList<T>::operator=(const ArrayList<T>&
  * @param src ArrayList to move
  * @return *this for chaining
  */
-template <typename T> ArrayList<T>& ArrayList<T>::operator=(ArrayList<T>&& src) noexcept
+template <typename T, typename Growth, typename Size>
+ArrayList<T, Growth, Size>& ArrayList<T, Growth, Size>::operator=(ArrayList&& src) noexcept
 {
     if (this == &src) {
         return *this;
     }
-    mSize = src.mSize;
-    mCapacity = src.mCapacity;
-    src.mSize = src.mCapacity = 0;
-    mArray.reset(src.mArray.release());
+    ArrayList(std::move(src)).swap(*this);
     return *this;
 }
 
@@ -93,7 +123,8 @@ template <typename T> ArrayList<T>& ArrayList<T>::operator=(ArrayList<T>&& src)
  * Adds the provided element to the end of this ArrayList.
  * @param value value to add
  */
-template <typename T> uint32_t ArrayList<T>::add(const T& value)
+template <typename T, typename Growth, typename Size>
+Size ArrayList<T, Growth, Size>::add(const T& value)
 {
     return add(mSize, value);
 }
@@ -106,61 +137,163 @@ template <typename T> uint32_t ArrayList<T>::add(const T& value)
  * @param index location at which to insert the new element
  * @param value the element to insert
  */
-template <typename T> uint32_t ArrayList<T>::add(uint32_t index, const T& value)
+template <typename T, typename Growth, typename Size>
+Size ArrayList<T, Growth, Size>::add(Size index, const T& value)
 {
-    if (index < mCapacity && mSize < mCapacity) {
-        for (u_int32_t i = mSize; i > index; i--) {
-            mArray[i] = mArray[i - 1];
+    emplace(index, value);
+    return mCapacity;
+}
+
+/**
+ * Moves the provided element to the end of this ArrayList.
+ * @param value value to move in
+ */
+template <typename T, typename Growth, typename Size>
+Size ArrayList<T, Growth, Size>::add(T&& value)
+{
+    emplace(mSize, std::move(value));
+    return mCapacity;
+}
+
+/**
+ * Constructs a new element from args at the specified index.
+ *
+ * Past the last element it is constructed in place. Before it, the tail is
+ * shifted in place when moving cannot throw; the element is built first
+ * since args may refer to an element of this list. Otherwise the list is
+ * rebuilt in a new buffer, so that a throwing copy leaves it unchanged.
+ * Trivially copyable elements are also built first when growing, so that
+ * the buffer can be grown with realloc.
+ * @param index location at which to construct the new element
+ * @param args arguments forwarded to a constructor of T
+ */
+template <typename T, typename Growth, typename Size>
+template <typename... Args>
+T& ArrayList<T, Growth, Size>::emplace(Size index, Args&&... args)
+{
+    if (index >= mCapacity || mSize >= mCapacity) {
+        if (std::max(mSize, index) == std::numeric_limits<Size>::max()) {
+            throw std::length_error("ArrayList size would overflow");
+        }
+        const Size capacity = grownCapacity(std::max(mSize, index) + 1);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            T value(std::forward<Args>(args)...);
+            reallocate(capacity);
+            return emplace(index, std::move(value));
+        } else {
+            reallocateAndEmplace(capacity, index, std::forward<Args>(args)...);
+            return mArray.get()[index];
+        }
+    }
+
+    T* data = mArray.get();
+    if (index >= mSize) {
+        ::new (static_cast<void*>(data + index)) T(std::forward<Args>(args)...);
+        try {
+            std::uninitialized_value_construct(data + mSize, data + index);
+        } catch (...) {
+            data[index].~T();
+            throw;
         }
-        mArray[index] = value;
-        mSize++;
-        return mCapacity;
+        mSize = index + 1;
+    } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        T value(std::forward<Args>(args)...);
+        shift(data + index, data + mSize, data + index + 1);
+        ::new (static_cast<void*>(data + index)) T(std::move(value));
+        ++mSize;
+    } else {
+        reallocateAndEmplace(mCapacity, index, std::forward<Args>(args)...);
     }
-    if (mCapacity == 0) {
-        mCapacity = 1;
+    return mArray.get()[index];
+}
+
+/**
+ * Constructs a new element from args at the end of this ArrayList.
+ * @param args arguments forwarded to a constructor of T
+ */
+template <typename T, typename Growth, typename Size>
+template <typename... Args>
+T& ArrayList<T, Growth, Size>::emplace_back(Args&&... args)
+{
+    return emplace(mSize, std::forward<Args>(args)...);
+}
+
+/**
+ * Enlarges the buffer to hold at least capacity elements.
+ * @param capacity the number of elements to make room for
+ */
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::reserve(Size capacity)
+{
+    if (capacity > mCapacity) {
+        reallocate(capacity);
     }
-    while (index >= mCapacity || mSize >= mCapacity) {
-        mCapacity *= 2;
+}
+
+/**
+ * Shrinks the buffer to exactly mSize elements.
+ */
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::shrink_to_fit()
+{
+    if (mSize < mCapacity) {
+        reallocate(mSize);
     }
-    // Seems ok ??
-    ScopedArray<T> tmp(new T[mCapacity]);
-    // T* tmp = new T[mCapacity];
-    u_int32_t min_index = std::min(index, mSize);
-    // for (u_int32_t i = 0; i < min_index; i++) {
-    //     tmp[i] = mArray[i];
-    // }
-    std::copy(mArray.get(), mArray.get() + min_index, tmp.get());
-    if (min_index < mSize) {
-        mSize++;
-        // for (u_int32_t i = mSize; i > index; i--) {
-        //     tmp[i] = mArray[i - 1];
-        // }
-        std::copy(mArray.get() + index, mArray.get() + mSize, tmp.get() + index + 1);
-        tmp[index] = value;
+}
+
+/**
+ * Inserts copies of the elements of [first, last) at the specified index.
+ * Ranges that can be walked twice are measured up front; single-pass ones
+ * are gathered into a temporary ArrayList whose elements are then moved.
+ * @param index location at which to insert the new elements
+ * @param first the beginning of the range to copy
+ * @param last the end of the range to copy
+ */
+template <typename T, typename Growth, typename Size>
+template <typename InputIt>
+Size ArrayList<T, Growth, Size>::insert(Size index, InputIt first, InputIt last)
+{
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        const auto count = std::distance(first, last);
+        using Distance = std::make_unsigned_t<decltype(count)>;
+        if (static_cast<Distance>(count) > std::numeric_limits<Size>::max()) {
+            throw std::length_error("ArrayList size would overflow");
+        }
+        insertCopies(index, first, static_cast<Size>(count));
     } else {
-        /*should use fill algorithm
-        for (u_int32_t i = min_index; i < index; i++) {
-            tmp[i] = T();
+        ArrayList items;
+        for (; first != last; ++first) {
+            items.emplace_back(*first);
         }
-        */
-        std::fill(tmp.get() + min_index, tmp.get() + index, T());
-        tmp[index] = value;
-        mSize = index + 1;
+        insertCopies(index, std::make_move_iterator(items.mArray.get()), items.mSize);
     }
-    mArray.reset(tmp.release());
     return mCapacity;
 }
 
+/**
+ * Appends copies of the elements of [first, last).
+ * @param first the beginning of the range to copy
+ * @param last the end of the range to copy
+ */
+template <typename T, typename Growth, typename Size>
+template <typename InputIt>
+Size ArrayList<T, Growth, Size>::append(InputIt first, InputIt last)
+{
+    return insert(mSize, first, last);
+}
+
 /**
  * Clears this ArrayList, leaving it empty.
  */
-template <typename T> void ArrayList<T>::clear()
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::clear()
 {
-    mArray.reset();
-    mSize = 0;
-    mCapacity = 0;
+    ArrayList().swap(*this);
 }
-template <typename T> void ArrayList<T>::check_range(const uint32_t& index) const
+
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::check_range(const Size& index) const
 {
     // no need to check uint32 < 0
     // if (index < 0 || index >= mSize) {
@@ -175,10 +308,11 @@ template <typename T> void ArrayList<T>::check_range(const uint32_t& index) cons
  * @param index the desired location
  * @return a const T & to the desired element.
  */
-template <typename T> const T& ArrayList<T>::get(uint32_t index) const
+template <typename T, typename Growth, typename Size>
+const T& ArrayList<T, Growth, Size>::get(Size index) const
 {
     check_range(index);
-    return mArray[index];
+    return mArray.get()[index];
 }
 
 /**
@@ -188,10 +322,11 @@ template <typename T> const T& ArrayList<T>::get(uint32_t index) const
  * @param index the desired location
  * @return a T & to the desired element.
  */
-template <typename T> T& ArrayList<T>::get(uint32_t index)
+template <typename T, typename Growth, typename Size>
+T& ArrayList<T, Growth, Size>::get(Size index)
 {
     check_range(index);
-    return mArray[index];
+    return mArray.get()[index];
 }
 
 /**
@@ -200,9 +335,10 @@ template <typename T> T& ArrayList<T>::get(uint32_t index)
  * @param index the desired location
  * @return a T & to the desired element.
  */
-template <typename T> T& ArrayList<T>::operator[](uint32_t index)
+template <typename T, typename Growth, typename Size>
+T& ArrayList<T, Growth, Size>::operator[](Size index)
 {
-    return mArray[index];
+    return mArray.get()[index];
 }
 
 /**
@@ -211,16 +347,18 @@ template <typename T> T& ArrayList<T>::operator[](uint32_t index)
  * @param index the desired location
  * @return a const T & to the desired element.
  */
-template <typename T> const T& ArrayList<T>::operator[](uint32_t index) const
+template <typename T, typename Growth, typename Size>
+const T& ArrayList<T, Growth, Size>::operator[](Size index) const
 {
-    return mArray[index];
+    return mArray.get()[index];
 }
 
 /**
  * Empty check.
  * @return True if this ArrayList is empty and false otherwise.
  */
-template <typename T> bool ArrayList<T>::isEmpty() const
+template <typename T, typename Growth, typename Size>
+bool ArrayList<T, Growth, Size>::isEmpty() const
 {
     return mSize == 0;
 }
@@ -229,7 +367,8 @@ template <typename T> bool ArrayList<T>::isEmpty() const
  * Returns iterator to the beginning; in this case, a random access iterator
  * @return an iterator to the beginning of this ArrayList.
  */
-template <typename T> ArrayListIterator<T> ArrayList<T>::begin()
+template <typename T, typename Growth, typename Size>
+ArrayListIterator<T> ArrayList<T, Growth, Size>::begin()
 {
     return iterator(mArray.get());
 }
@@ -238,7 +377,8 @@ template <typename T> ArrayListIterator<T> ArrayList<T>::begin()
  * Returns the past-the-end iterator of this ArrayList.
  * @return a past-the-end iterator of this ArrayList.
  */
-template <typename T> ArrayListIterator<T> ArrayList<T>::end()
+template <typename T, typename Growth, typename Size>
+ArrayListIterator<T> ArrayList<T, Growth, Size>::end()
 {
     return iterator(mArray.get() + mSize);
 }
@@ -248,7 +388,8 @@ template <typename T> ArrayListIterator<T> ArrayList<T>::end()
  * iterator
  * @return an const iterator to the beginning of this ArrayList.
  */
-template <typename T> typename ArrayList<T>::const_iterator ArrayList<T>::begin() const
+template <typename T, typename Growth, typename Size>
+typename ArrayList<T, Growth, Size>::const_iterator ArrayList<T, Growth, Size>::begin() const
 {
     return const_iterator(mArray.get());
 }
@@ -257,28 +398,30 @@ template <typename T> typename ArrayList<T>::const_iterator ArrayList<T>::begin(
  * Returns the past-the-end const iterator of this ArrayList.
  * @return a past-the-end const iterator of this ArrayList.
  */
-template <typename T> typename ArrayList<T>::const_iterator ArrayList<T>::end() const
+template <typename T, typename Growth, typename Size>
+typename ArrayList<T, Growth, Size>::const_iterator ArrayList<T, Growth, Size>::end() const
 {
     return const_iterator(mArray.get() + mSize);
 }
 
 /**
- * Removes an element at the specified location from this ArrayList and
- * returns it. Elements following index are shifted down. If index is out of
- * range, std::out_of_range is thrown with index as its message.
+ * Removes an element at the specified location from this ArrayList.
+ * Elements following index are shifted down. If index is out of range,
+ * std::out_of_range is thrown with index as its message.
  * @param index the desired location
- * @return a copy of the removed element.
  */
-template <typename T> void ArrayList<T>::remove(uint32_t index)
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::remove(Size index)
 {
     check_range(index);
-    T ret = mArray[index];
-    std::copy(mArray.get() + index + 1, mArray.get() + mSize, mArray.get() + index);
-    // for (uint32_t i = index + 1; i < mSize; i++) {
-    //     mArray[i - 1] = mArray[i];
-    // }
-    mSize--;
-    return ret;
+    if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        T* data = mArray.get();
+        data[index].~T();
+        shift(data + index + 1, data + mSize, data + index);
+        mSize--;
+    } else {
+        reallocateAndRemove(index);
+    }
 }
 
 /**
@@ -287,25 +430,38 @@ template <typename T> void ArrayList<T>::remove(uint32_t index)
  * @param index the location to change
  * @param value the new value of the specified element.
  */
-template <typename T> void ArrayList<T>::set(uint32_t index, const T& value)
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::set(Size index, const T& value)
 {
     check_range(index);
-    mArray[index] = value;
+    mArray.get()[index] = value;
 }
 
 /**
  * Returns the size of this ArrayList.
  * @return the size of this ArrayList.
  */
-template <typename T> uint32_t ArrayList<T>::size() const
+template <typename T, typename Growth, typename Size>
+Size ArrayList<T, Growth, Size>::size() const
 {
     return mSize;
 }
 
+/**
+ * Returns the number of elements the buffer can hold without growing.
+ * @return the capacity of this ArrayList.
+ */
+template <typename T, typename Growth, typename Size>
+Size ArrayList<T, Growth, Size>::capacity() const
+{
+    return mCapacity;
+}
+
 /**
  * Perform an exception-safe swap of the contents of *this with src.
  */
-template <typename T> void ArrayList<T>::swap(ArrayList<T>& src) noexcept
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::swap(ArrayList& src) noexcept
 {
     if (this != &src) {
         mArray.swap(src.mArray);
@@ -314,4 +470,240 @@ template <typename T> void ArrayList<T>::swap(ArrayList<T>& src) noexcept
     }
 }
 
+/**
+ * Constructs [first, last) into the uninitialized storage at dest.
+ */
+template <typename T, typename Growth, typename Size>
+T* ArrayList<T, Growth, Size>::relocate(T* first, T* last, T* dest)
+{
+    T* out = dest;
+    try {
+        for (; first != last; ++first, ++out) {
+            ::new (static_cast<void*>(out)) T(std::move_if_noexcept(*first));
+        }
+    } catch (...) {
+        std::destroy(dest, out);
+        throw;
+    }
+    return out;
+}
+
+/**
+ * Copies count elements starting at first into the storage at dest. Only
+ * pointers to T and the ArrayList's own iterators are known to walk
+ * contiguous storage.
+ */
+template <typename T, typename Growth, typename Size>
+template <typename ForwardIt>
+void ArrayList<T, Growth, Size>::copyConstruct(ForwardIt first, Size count, T* dest)
+{
+    constexpr bool contiguous = std::is_same_v<ForwardIt, T*>
+        || std::is_same_v<ForwardIt, const T*>
+        || std::is_same_v<ForwardIt, ArrayListIterator<T>>
+        || std::is_same_v<ForwardIt, ArrayListConstIterator<T>>;
+    if constexpr (std::is_trivially_copyable_v<T> && contiguous) {
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(dest), &*first, count * sizeof(T));
+        }
+    } else {
+        std::uninitialized_copy_n(first, count, dest);
+    }
+}
+
+/**
+ * Moves [first, last) to dest, front to back when moving down and back to
+ * front when moving up, so that every element is moved out of its slot
+ * before another one is moved into it.
+ */
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::shift(T* first, T* last, T* dest) noexcept
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memmove(static_cast<void*>(dest), first, (last - first) * sizeof(T));
+    } else if (dest < first) {
+        for (; first != last; ++first, ++dest) {
+            ::new (static_cast<void*>(dest)) T(std::move(*first));
+            first->~T();
+        }
+    } else {
+        for (dest += last - first; first != last;) {
+            --last;
+            --dest;
+            ::new (static_cast<void*>(dest)) T(std::move(*last));
+            last->~T();
+        }
+    }
+}
+
+/**
+ * Asks the growth policy for a capacity of at least size.
+ */
+template <typename T, typename Growth, typename Size>
+Size ArrayList<T, Growth, Size>::grownCapacity(Size size) const
+{
+    return Growth::template grow<T>(mCapacity, size);
+}
+
+/**
+ * Relocates the elements into a fresh buffer and only destroys the old
+ * ones once they have all been constructed there. Trivially copyable
+ * elements are left to realloc instead, which may not need to copy them.
+ */
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::reallocate(Size capacity)
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        mArray.resize(capacity);
+        mCapacity = capacity;
+        return;
+    }
+    ScopedBuffer<T> buffer(capacity);
+    relocate(mArray.get(), mArray.get() + mSize, buffer.get());
+    std::destroy_n(mArray.get(), mSize);
+    mArray.swap(buffer);
+    mCapacity = capacity;
+}
+
+/**
+ * Builds the new contents in a fresh buffer: the new element first, while
+ * every element args could refer to is still in place, then the default
+ * values of any gap and only then the elements before and after index, so
+ * that nothing but relocating them can throw once they may have been
+ * moved. The old elements are only destroyed once nothing can throw any
+ * more.
+ */
+template <typename T, typename Growth, typename Size>
+template <typename... Args>
+void ArrayList<T, Growth, Size>::reallocateAndEmplace(Size capacity, Size index, Args&&... args)
+{
+    ScopedBuffer<T> buffer(capacity);
+    T* data = buffer.get();
+    T* old = mArray.get();
+    const Size front = std::min(index, mSize);
+
+    ::new (static_cast<void*>(data + index)) T(std::forward<Args>(args)...);
+    try {
+        std::uninitialized_value_construct(data + front, data + index);
+    } catch (...) {
+        data[index].~T();
+        throw;
+    }
+    T* built = data;
+    try {
+        built = relocate(old, old + front, data);
+        relocate(old + front, old + mSize, data + index + 1);
+    } catch (...) {
+        std::destroy(data, built);
+        std::destroy(data + front, data + index + 1);
+        throw;
+    }
+
+    std::destroy_n(old, mSize);
+    mArray.swap(buffer);
+    mSize = std::max(mSize, index) + 1;
+    mCapacity = capacity;
+}
+
+/**
+ * Within capacity, with moves that cannot throw, the elements from index
+ * on are shifted up by count and the copies constructed in the hole; a
+ * throwing copy shifts them back. Otherwise the new contents are built in
+ * a fresh buffer: the copies, the default values of any gap and only then
+ * the elements before and after index, as in reallocateAndEmplace().
+ * Trivially copyable elements always take the first path, after growing
+ * with realloc.
+ */
+template <typename T, typename Growth, typename Size>
+template <typename ForwardIt>
+void ArrayList<T, Growth, Size>::insertCopies(Size index, ForwardIt first, Size count)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count > std::numeric_limits<Size>::max() - std::max(mSize, index)) {
+        throw std::length_error("ArrayList size would overflow");
+    }
+    const Size size = std::max(mSize, index) + count;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (size > mCapacity) {
+            reallocate(grownCapacity(size));
+        }
+    }
+    if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        if (size <= mCapacity) {
+            T* data = mArray.get();
+            if (index > mSize) {
+                std::uninitialized_value_construct(data + mSize, data + index);
+                try {
+                    copyConstruct(first, count, data + index);
+                } catch (...) {
+                    std::destroy(data + mSize, data + index);
+                    throw;
+                }
+            } else {
+                shift(data + index, data + mSize, data + index + count);
+                try {
+                    copyConstruct(first, count, data + index);
+                } catch (...) {
+                    shift(data + index + count, data + mSize + count, data + index);
+                    throw;
+                }
+            }
+            mSize = size;
+            return;
+        }
+    }
+
+    const Size capacity = size <= mCapacity ? mCapacity : grownCapacity(size);
+    ScopedBuffer<T> buffer(capacity);
+    T* data = buffer.get();
+    T* old = mArray.get();
+    const Size front = std::min(index, mSize);
+
+    copyConstruct(first, count, data + index);
+    try {
+        std::uninitialized_value_construct(data + front, data + index);
+    } catch (...) {
+        std::destroy_n(data + index, count);
+        throw;
+    }
+    T* built = data;
+    try {
+        built = relocate(old, old + front, data);
+        relocate(old + front, old + mSize, data + index + count);
+    } catch (...) {
+        std::destroy(data, built);
+        std::destroy(data + front, data + index + count);
+        throw;
+    }
+
+    std::destroy_n(old, mSize);
+    mArray.swap(buffer);
+    mSize = size;
+    mCapacity = capacity;
+}
+
+/**
+ * Relocates every element but the one at index into a buffer of the same
+ * capacity.
+ */
+template <typename T, typename Growth, typename Size>
+void ArrayList<T, Growth, Size>::reallocateAndRemove(Size index)
+{
+    ScopedBuffer<T> buffer(mCapacity);
+    T* data = buffer.get();
+    T* old = mArray.get();
+    T* built = relocate(old, old + index, data);
+    try {
+        relocate(old + index + 1, old + mSize, built);
+    } catch (...) {
+        std::destroy(data, built);
+        throw;
+    }
+
+    std::destroy_n(old, mSize);
+    mArray.swap(buffer);
+    mSize--;
+}
+
 #endif // ARRAYLIST_CPP
@@ -0,0 +1,133 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "BodyStore.h"
+#include "SymbolTable.h"
+
+/**
+ *  Interns the name and appends a body.
+ */
+uint32_t BodyStore::add(std::string_view name, double m, const vector2& pos, const vector2& vel)
+{
+    return add(symbols::intern(name), m, pos, vel);
+}
+
+/**
+ *  Appends a body and returns its slot.
+ */
+uint32_t BodyStore::add(uint32_t nameId, double m, const vector2& pos, const vector2& vel)
+{
+    x.push_back(pos[0]);
+    y.push_back(pos[1]);
+    vx.push_back(vel[0]);
+    vy.push_back(vel[1]);
+    nextX.push_back(pos[0]);
+    nextY.push_back(pos[1]);
+    nextVX.push_back(vel[0]);
+    nextVY.push_back(vel[1]);
+    mass.push_back(m);
+    names.push_back(nameId);
+    ++revision;
+    return static_cast<uint32_t>(names.size() - 1);
+}
+
+/**
+ *  Makes room for count bodies in total.
+ */
+void BodyStore::reserve(uint32_t count)
+{
+    x.reserve(count);
+    y.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    nextX.reserve(count);
+    nextY.reserve(count);
+    nextVX.reserve(count);
+    nextVY.reserve(count);
+    mass.reserve(count);
+    names.reserve(count);
+}
+
+/**
+ *  Returns the number of bodies.
+ */
+uint32_t BodyStore::size() const noexcept
+{
+    return static_cast<uint32_t>(names.size());
+}
+
+/**
+ *  Removes every body. Capacity is retained.
+ */
+void BodyStore::clear() noexcept
+{
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    nextX.clear();
+    nextY.clear();
+    nextVX.clear();
+    nextVY.clear();
+    mass.clear();
+    names.clear();
+    ++revision;
+}
+
+/**
+ *  Exchanges the front and back position and velocity columns.
+ */
+void BodyStore::flip() noexcept
+{
+    x.swap(nextX);
+    y.swap(nextY);
+    vx.swap(nextVX);
+    vy.swap(nextVY);
+}
+
+/**
+ *  Returns the name of the body in slot.
+ */
+std::string_view BodyStore::getName(uint32_t slot) const noexcept
+{
+    return symbols::lookup(names[slot]);
+}
+
+/**
+ *  Returns the position of the body in slot as a vector.
+ */
+vector2 BodyStore::getPosition(uint32_t slot) const noexcept
+{
+    vector2 pos;
+    pos[0] = x[slot];
+    pos[1] = y[slot];
+    return pos;
+}
+
+/**
+ *  Returns the velocity of the body in slot as a vector.
+ */
+vector2 BodyStore::getVelocity(uint32_t slot) const noexcept
+{
+    vector2 vel;
+    vel[0] = vx[slot];
+    vel[1] = vy[slot];
+    return vel;
+}
+
+/**
+ *  Sets the position of the body in slot.
+ */
+void BodyStore::setPosition(uint32_t slot, const vector2& pos) noexcept
+{
+    x[slot] = pos[0];
+    y[slot] = pos[1];
+    ++revision;
+}
+
+/**
+ *  Sets the velocity of the body in slot.
+ */
+void BodyStore::setVelocity(uint32_t slot, const vector2& vel) noexcept
+{
+    vx[slot] = vel[0];
+    vy[slot] = vel[1];
+}
@@ -0,0 +1,217 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "Checkpointer.h"
+#include "SnapshotFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+
+const std::string SUFFIX = ".snap";
+
+/**
+ *  Width of the zero padded step in a file name, so that names sort by
+ *  step.
+ */
+const size_t STEP_DIGITS = 20;
+
+} // namespace
+
+/**
+ *  Deletes the checkpoints after start and starts the I/O thread.
+ */
+Checkpointer::Checkpointer(
+    std::string prefix, uint64_t interval, unsigned retention, uint64_t start)
+    : prefix(std::move(prefix))
+    , interval(interval)
+    , retention(retention)
+    , start(start)
+{
+    if (interval == 0 || retention == 0) {
+        throw std::invalid_argument("checkpoint interval and retention must be positive");
+    }
+    for (uint64_t step : list(this->prefix)) {
+        if (step > start) {
+            std::remove(pathFor(this->prefix, step).c_str());
+        }
+    }
+    writer = std::thread(&Checkpointer::writerLoop, this);
+}
+
+/**
+ *  Writes the pending checkpoint and stops the I/O thread.
+ */
+Checkpointer::~Checkpointer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+/**
+ *  Copies the front columns of bodies into the pending buffer when step
+ *  is a multiple of the interval.
+ */
+void Checkpointer::onStep(uint64_t step, const BodyStore& bodies)
+{
+    if (step % interval != 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hasPending) {
+            ++skipped;
+        }
+        pending.x = bodies.x;
+        pending.y = bodies.y;
+        pending.vx = bodies.vx;
+        pending.vy = bodies.vy;
+        pending.mass = bodies.mass;
+        pending.names = bodies.names;
+        pendingStep = step;
+        hasPending = true;
+    }
+    wake.notify_one();
+}
+
+/**
+ *  Waits until nothing is pending or being written.
+ */
+void Checkpointer::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !hasPending && !busy; });
+    if (error) {
+        std::exception_ptr first = error;
+        error = nullptr;
+        std::rethrow_exception(first);
+    }
+}
+
+/**
+ *  Returns the number of checkpoints written.
+ */
+uint64_t Checkpointer::getWritten() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+/**
+ *  Returns the number of checkpoints replaced before they were written.
+ */
+uint64_t Checkpointer::getSkipped() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return skipped;
+}
+
+/**
+ *  Returns prefix.<step>.snap with the step zero padded.
+ */
+std::string Checkpointer::pathFor(const std::string& prefix, uint64_t step)
+{
+    std::string digits = std::to_string(step);
+    return prefix + "." + std::string(STEP_DIGITS - digits.size(), '0') + digits + SUFFIX;
+}
+
+/**
+ *  Scans the directory of prefix for files named like pathFor() makes.
+ */
+std::vector<uint64_t> Checkpointer::list(const std::string& prefix)
+{
+    namespace fs = std::filesystem;
+    const fs::path base(prefix);
+    const std::string stem = base.filename().string() + ".";
+    const fs::path directory = base.has_parent_path() ? base.parent_path() : fs::path(".");
+
+    std::vector<uint64_t> steps;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() != stem.size() + STEP_DIGITS + SUFFIX.size()
+            || name.compare(0, stem.size(), stem) != 0
+            || name.compare(stem.size() + STEP_DIGITS, SUFFIX.size(), SUFFIX) != 0) {
+            continue;
+        }
+        const std::string digits = name.substr(stem.size(), STEP_DIGITS);
+        if (std::all_of(
+                digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            steps.push_back(std::stoull(digits));
+        }
+    }
+    std::sort(steps.begin(), steps.end());
+    return steps;
+}
+
+/**
+ *  Takes the pending state, writes it without holding the lock and
+ *  prunes old files, until asked to stop with nothing left pending.
+ */
+void Checkpointer::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return hasPending || stopping; });
+        if (!hasPending) {
+            return;
+        }
+        std::swap(pending, writing);
+        const uint64_t step = pendingStep;
+        hasPending = false;
+        busy = true;
+        lock.unlock();
+
+        std::exception_ptr failure;
+        try {
+            snapshot::save(writing, pathFor(prefix, step).c_str());
+            prune(step);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        lock.lock();
+        busy = false;
+        if (!failure) {
+            ++written;
+        } else if (!error) {
+            error = failure;
+        }
+        if (!hasPending) {
+            idle.notify_all();
+        }
+    }
+}
+
+/**
+ *  Inserts step into the kept steps, which stay sorted even if the
+ *  simulation was sent back by resume(), and deletes the oldest ones.
+ */
+void Checkpointer::prune(uint64_t step)
+{
+    if (!adopted) {
+        for (uint64_t previous : list(prefix)) {
+            if (previous <= start && previous != step) {
+                kept.push_back(previous);
+            }
+        }
+        adopted = true;
+    }
+    auto position = std::lower_bound(kept.begin(), kept.end(), step);
+    if (position == kept.end() || *position != step) {
+        kept.insert(position, step);
+    }
+    if (kept.size() <= retention) {
+        return;
+    }
+    const size_t excess = kept.size() - retention;
+    for (size_t i = 0; i < excess; ++i) {
+        std::remove(pathFor(prefix, kept[i]).c_str());
+    }
+    kept.erase(kept.begin(), kept.begin() + excess);
+}
@@ -0,0 +1,187 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "CompositeObject.h"
+#include "Universe.h"
+#include "Visitor.h"
+
+#include <stdexcept>
+
+namespace {
+
+/**
+ *  Returns the mass weighted average of member(child) over the children,
+ *  or the plain average if they are all massless.
+ */
+vector2 weightedAverage(
+    const ArrayList<Object*>& children, vector2 (Object::*member)() const noexcept)
+{
+    vector2 sum;
+    vector2 plain;
+    double total = 0;
+    for (const Object* child : children) {
+        const double mass = child->getMass();
+        const vector2 value = (child->*member)();
+        sum += value * mass;
+        plain += value;
+        total += mass;
+    }
+    if (total != 0) {
+        return sum / total;
+    }
+    return children.size() == 0 ? plain : plain / children.size();
+}
+
+} // namespace
+
+/**
+ *  Initializes an empty composite.
+ */
+CompositeObject::CompositeObject(uint32_t nameId, bool registered)
+    : Object(nameId, 0, vector2(), vector2())
+    , registered(registered)
+{
+}
+
+/**
+ *  Deletes the members of a detached composite.
+ */
+CompositeObject::~CompositeObject()
+{
+    if (!registered) {
+        for (auto child : children) {
+            delete child;
+        }
+    }
+}
+
+/**
+ *  Visits this composite, then every member.
+ */
+void CompositeObject::accept(Visitor& visitor)
+{
+    visitor.visit(*this);
+    for (auto child : children) {
+        child->accept(visitor);
+    }
+}
+
+/**
+ *  Returns a detached composite owning deep copies of the members.
+ */
+Object* CompositeObject::clone() const
+{
+    auto copy = new CompositeObject(getNameId(), false);
+    try {
+        for (const Object* child : children) {
+            copy->add(child->clone());
+        }
+    } catch (...) {
+        delete copy;
+        throw;
+    }
+    return copy;
+}
+
+/**
+ *  Returns the total mass of the members.
+ */
+double CompositeObject::getMass() const noexcept
+{
+    double total = 0;
+    for (const Object* child : children) {
+        total += child->getMass();
+    }
+    return total;
+}
+
+/**
+ *  Returns the center of mass of the members.
+ */
+vector2 CompositeObject::getPosition() const noexcept
+{
+    return weightedAverage(children, &Object::getPosition);
+}
+
+/**
+ *  Returns the velocity of the center of mass of the members.
+ */
+vector2 CompositeObject::getVelocity() const noexcept
+{
+    return weightedAverage(children, &Object::getVelocity);
+}
+
+/**
+ *  Moves every member by the offset from the current center of mass.
+ */
+void CompositeObject::setPosition(const vector2& pos)
+{
+    const vector2 offset = pos - getPosition();
+    for (auto child : children) {
+        child->setPosition(child->getPosition() + offset);
+    }
+}
+
+/**
+ *  Changes the velocity of every member by the same amount.
+ */
+void CompositeObject::setVelocity(const vector2& vel)
+{
+    const vector2 offset = vel - getVelocity();
+    for (auto child : children) {
+        child->setVelocity(child->getVelocity() + offset);
+    }
+}
+
+/**
+ *  Checks child and adds it as a member. The Universe is told that its
+ *  hierarchy changed when this composite is registered.
+ */
+void CompositeObject::add(Object* child)
+{
+    if (child == nullptr) {
+        throw std::invalid_argument("composite member must not be null");
+    }
+    if (child->parent != nullptr) {
+        throw std::invalid_argument("object is already a member of a composite");
+    }
+    for (const Object* ancestor = this; ancestor != nullptr; ancestor = ancestor->parent) {
+        if (ancestor == child) {
+            throw std::invalid_argument("composite must not contain itself");
+        }
+    }
+    if (isRegisteredObject(*child) != registered) {
+        throw std::invalid_argument(registered
+                ? "members of a registered composite must be registered"
+                : "members of a detached composite must be detached");
+    }
+    children.add(child);
+    child->parent = this;
+    if (registered) {
+        Universe::instance()->compositesChanged();
+    }
+}
+
+/**
+ *  Returns the members in the order they were added.
+ */
+const ArrayList<Object*>& CompositeObject::getChildren() const noexcept
+{
+    return children;
+}
+
+/**
+ *  Returns true if the composite was made by the ObjectFactory.
+ */
+bool CompositeObject::isRegistered() const noexcept
+{
+    return registered;
+}
+
+/**
+ *  Registered Objects are bound to the Universe's store; registered
+ *  composites are marked as such.
+ */
+bool CompositeObject::isRegisteredObject(const Object& object) noexcept
+{
+    auto composite = dynamic_cast<const CompositeObject*>(&object);
+    return composite != nullptr ? composite->registered : object.store != nullptr;
+}
@@ -0,0 +1,176 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include <algorithm>
+#include <stdexcept>
+
+#include "CompositeTree.h"
+#include "Gravity.h"
+
+/**
+ *  Creates an empty tree with the provided opening angle.
+ */
+CompositeTree::CompositeTree(double theta)
+    : theta(0)
+{
+    setOpeningAngle(theta);
+}
+
+/**
+ *  Sets the opening angle. Must not be negative.
+ */
+void CompositeTree::setOpeningAngle(double theta)
+{
+    if (!(theta >= 0)) {
+        throw std::invalid_argument("opening angle must not be negative");
+    }
+    this->theta = theta;
+}
+
+/**
+ *  Returns the opening angle.
+ */
+double CompositeTree::getOpeningAngle() const noexcept
+{
+    return theta;
+}
+
+/**
+ *  Returns the number of bodies and groups in the tree.
+ */
+uint32_t CompositeTree::nodeCount() const noexcept
+{
+    return static_cast<uint32_t>(nodes.size());
+}
+
+/**
+ *  Removes every node and prepares for count bodies.
+ */
+void CompositeTree::clear(uint32_t count)
+{
+    nodes.clear();
+    order.clear();
+    order.reserve(count);
+    rank.assign(count, 0);
+}
+
+/**
+ *  Appends a leaf and records where the body sits in preorder.
+ */
+void CompositeTree::addBody(uint32_t index)
+{
+    if (index >= rank.size()) {
+        throw std::out_of_range("body index out of range");
+    }
+    const auto position = static_cast<uint32_t>(order.size());
+    rank[index] = position;
+    order.push_back(index);
+    const auto next = static_cast<uint32_t>(nodes.size()) + 1;
+    nodes.push_back(Node { index, position, position + 1, next, 0, 0, 0, 0 });
+}
+
+/**
+ *  Appends a group whose range of bodies is completed by closeGroup().
+ */
+uint32_t CompositeTree::openGroup()
+{
+    const auto position = static_cast<uint32_t>(order.size());
+    nodes.push_back(Node { GROUP, position, position, 0, 0, 0, 0, 0 });
+    return static_cast<uint32_t>(nodes.size()) - 1;
+}
+
+/**
+ *  Closes the range of bodies of group, which now ends at the last body
+ *  added, and points its skip past its members.
+ */
+void CompositeTree::closeGroup(uint32_t group)
+{
+    Node& node = nodes.at(group);
+    node.last = static_cast<uint32_t>(order.size());
+    node.skip = static_cast<uint32_t>(nodes.size());
+}
+
+/**
+ *  Sums the members of every group into its center of mass, then takes
+ *  the farthest member from it as the radius. Massless groups exert no
+ *  force and are skipped by getForce().
+ */
+void CompositeTree::update(const double* x, const double* y, const double* mass)
+{
+    this->x = x;
+    this->y = y;
+    this->mass = mass;
+    for (Node& node : nodes) {
+        if (node.body != GROUP) {
+            continue;
+        }
+        double total = 0;
+        double sumX = 0;
+        double sumY = 0;
+        for (uint32_t i = node.first; i < node.last; ++i) {
+            const uint32_t body = order[i];
+            total += mass[body];
+            sumX += mass[body] * x[body];
+            sumY += mass[body] * y[body];
+        }
+        node.mass = total;
+        if (total == 0) {
+            continue;
+        }
+        node.comX = sumX / total;
+        node.comY = sumY / total;
+        double radiusSq = 0;
+        for (uint32_t i = node.first; i < node.last; ++i) {
+            const double dx = x[order[i]] - node.comX;
+            const double dy = y[order[i]] - node.comY;
+            radiusSq = std::max(radiusSq, dx * dx + dy * dy);
+        }
+        node.radiusSq = radiusSq;
+    }
+}
+
+/**
+ *  Walks the nodes in preorder. A group holding the body, or failing the
+ *  radius over distance criterion, is opened by stepping into its
+ *  members; any other group is summed as a point mass and its members
+ *  are skipped.
+ */
+vector2 CompositeTree::getForce(uint32_t index) const
+{
+    const double xi = x[index];
+    const double yi = y[index];
+    const double mi = mass[index];
+    const uint32_t position = rank[index];
+    const double thetaSq = theta * theta;
+    double fx = 0;
+    double fy = 0;
+
+    const auto count = static_cast<uint32_t>(nodes.size());
+    for (uint32_t n = 0; n < count;) {
+        const Node& node = nodes[n];
+        if (node.body != GROUP) {
+            if (node.body != index) {
+                gravity::addPairForce(
+                    xi, yi, mi, x[node.body], y[node.body], mass[node.body], fx, fy);
+            }
+            ++n;
+            continue;
+        }
+        if (node.mass == 0) {
+            n = node.skip;
+            continue;
+        }
+        const bool inside = position >= node.first && position < node.last;
+        const double dx = node.comX - xi;
+        const double dy = node.comY - yi;
+        if (!inside && node.radiusSq < thetaSq * (dx * dx + dy * dy)) {
+            gravity::addPairForce(xi, yi, mi, node.comX, node.comY, node.mass, fx, fy);
+            n = node.skip;
+        } else {
+            ++n;
+        }
+    }
+
+    vector2 force;
+    force[0] = fx;
+    force[1] = fy;
+    return force;
+}
@@ -0,0 +1,240 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include <cfloat>
+#include <stdexcept>
+
+#include "Gravity.h"
+#include "GravityKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GRAVITY_X86 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define GRAVITY_X86 0
+#endif
+
+namespace gravity {
+namespace {
+
+/**
+ *  Reference kernel: addPairForce() over the range, in order.
+ */
+void forceScalar(double xi, double yi, double mi, const double* x, const double* y,
+    const double* mass, uint32_t begin, uint32_t end, double& fx, double& fy)
+{
+    for (uint32_t j = begin; j < end; ++j) {
+        addPairForce(xi, yi, mi, x[j], y[j], mass[j], fx, fy);
+    }
+}
+
+#if GRAVITY_X86
+
+/**
+ *  Two lane 1 / sqrt(r2). The 12 bit single precision estimate is refined
+ *  by three Newton-Raphson steps; lanes outside the single precision
+ *  range fall back to an exact division.
+ */
+TARGET_SSE2 inline __m128d rsqrtSSE2(__m128d r2)
+{
+    const __m128d half = _mm_mul_pd(_mm_set1_pd(0.5), r2);
+    const __m128d threeHalves = _mm_set1_pd(1.5);
+    __m128d inv = _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(r2)));
+    for (int i = 0; i < 3; ++i) {
+        inv = _mm_mul_pd(inv, _mm_sub_pd(threeHalves, _mm_mul_pd(half, _mm_mul_pd(inv, inv))));
+    }
+    __m128d outside = _mm_or_pd(_mm_cmplt_pd(r2, _mm_set1_pd(FLT_MIN)),
+        _mm_cmpgt_pd(r2, _mm_set1_pd(FLT_MAX)));
+    if (_mm_movemask_pd(outside)) {
+        __m128d exact = _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(r2));
+        inv = _mm_or_pd(_mm_and_pd(outside, exact), _mm_andnot_pd(outside, inv));
+    }
+    return inv;
+}
+
+TARGET_SSE2 void forceSSE2(double xi, double yi, double mi, const double* x,
+    const double* y, const double* mass, uint32_t begin, uint32_t end, double& fx, double& fy)
+{
+    const __m128d pxi = _mm_set1_pd(xi);
+    const __m128d pyi = _mm_set1_pd(yi);
+    const __m128d gmi = _mm_set1_pd(G * mi);
+    const __m128d zero = _mm_setzero_pd();
+    __m128d accX = zero;
+    __m128d accY = zero;
+    uint32_t j = begin;
+    for (; j + 2 <= end; j += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + j), pxi);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + j), pyi);
+        __m128d r2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        __m128d inv = rsqrtSSE2(r2);
+        __m128d inv3 = _mm_mul_pd(_mm_mul_pd(inv, inv), inv);
+        __m128d s = _mm_mul_pd(_mm_mul_pd(gmi, _mm_loadu_pd(mass + j)), inv3);
+        s = _mm_and_pd(s, _mm_cmpneq_pd(r2, zero));
+        accX = _mm_add_pd(accX, _mm_mul_pd(s, dx));
+        accY = _mm_add_pd(accY, _mm_mul_pd(s, dy));
+    }
+    double lanesX[2];
+    double lanesY[2];
+    _mm_storeu_pd(lanesX, accX);
+    _mm_storeu_pd(lanesY, accY);
+    fx += lanesX[0] + lanesX[1];
+    fy += lanesY[0] + lanesY[1];
+    forceScalar(xi, yi, mi, x, y, mass, j, end, fx, fy);
+}
+
+/**
+ *  Four lane 1 / sqrt(r2), refined like rsqrtSSE2().
+ */
+TARGET_AVX2 inline __m256d rsqrtAVX2(__m256d r2)
+{
+    const __m256d half = _mm256_mul_pd(_mm256_set1_pd(0.5), r2);
+    const __m256d threeHalves = _mm256_set1_pd(1.5);
+    __m256d inv = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(r2)));
+    for (int i = 0; i < 3; ++i) {
+        inv = _mm256_mul_pd(
+            inv, _mm256_sub_pd(threeHalves, _mm256_mul_pd(half, _mm256_mul_pd(inv, inv))));
+    }
+    __m256d outside = _mm256_or_pd(_mm256_cmp_pd(r2, _mm256_set1_pd(FLT_MIN), _CMP_LT_OQ),
+        _mm256_cmp_pd(r2, _mm256_set1_pd(FLT_MAX), _CMP_GT_OQ));
+    if (_mm256_movemask_pd(outside)) {
+        __m256d exact = _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(r2));
+        inv = _mm256_blendv_pd(inv, exact, outside);
+    }
+    return inv;
+}
+
+TARGET_AVX2 void forceAVX2(double xi, double yi, double mi, const double* x, const double* y,
+    const double* mass, uint32_t begin, uint32_t end, double& fx, double& fy)
+{
+    const __m256d pxi = _mm256_set1_pd(xi);
+    const __m256d pyi = _mm256_set1_pd(yi);
+    const __m256d gmi = _mm256_set1_pd(G * mi);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d accX = zero;
+    __m256d accY = zero;
+    uint32_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), pxi);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), pyi);
+        __m256d r2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m256d inv = rsqrtAVX2(r2);
+        __m256d inv3 = _mm256_mul_pd(_mm256_mul_pd(inv, inv), inv);
+        __m256d s = _mm256_mul_pd(_mm256_mul_pd(gmi, _mm256_loadu_pd(mass + j)), inv3);
+        s = _mm256_and_pd(s, _mm256_cmp_pd(r2, zero, _CMP_NEQ_OQ));
+        accX = _mm256_add_pd(accX, _mm256_mul_pd(s, dx));
+        accY = _mm256_add_pd(accY, _mm256_mul_pd(s, dy));
+    }
+    double lanesX[4];
+    double lanesY[4];
+    _mm256_storeu_pd(lanesX, accX);
+    _mm256_storeu_pd(lanesY, accY);
+    fx += (lanesX[0] + lanesX[1]) + (lanesX[2] + lanesX[3]);
+    fy += (lanesY[0] + lanesY[1]) + (lanesY[2] + lanesY[3]);
+    forceScalar(xi, yi, mi, x, y, mass, j, end, fx, fy);
+}
+
+/**
+ *  Eight lane 1 / sqrt(r2). The 14 bit estimate covers the whole double
+ *  range, so two Newton-Raphson steps and no fallback are needed.
+ */
+TARGET_AVX512 inline __m512d rsqrtAVX512(__m512d r2)
+{
+    const __m512d half = _mm512_mul_pd(_mm512_set1_pd(0.5), r2);
+    const __m512d threeHalves = _mm512_set1_pd(1.5);
+    __m512d inv = _mm512_maskz_rsqrt14_pd(0xFF, r2);
+    for (int i = 0; i < 2; ++i) {
+        inv = _mm512_mul_pd(
+            inv, _mm512_sub_pd(threeHalves, _mm512_mul_pd(half, _mm512_mul_pd(inv, inv))));
+    }
+    return inv;
+}
+
+TARGET_AVX512 void forceAVX512(double xi, double yi, double mi, const double* x,
+    const double* y, const double* mass, uint32_t begin, uint32_t end, double& fx, double& fy)
+{
+    const __m512d pxi = _mm512_set1_pd(xi);
+    const __m512d pyi = _mm512_set1_pd(yi);
+    const __m512d gmi = _mm512_set1_pd(G * mi);
+    const __m512d zero = _mm512_setzero_pd();
+    __m512d accX = zero;
+    __m512d accY = zero;
+    uint32_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + j), pxi);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + j), pyi);
+        __m512d r2 = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+        __m512d inv = rsqrtAVX512(r2);
+        __m512d inv3 = _mm512_mul_pd(_mm512_mul_pd(inv, inv), inv);
+        __mmask8 apart = _mm512_cmp_pd_mask(r2, zero, _CMP_NEQ_OQ);
+        __m512d gm = _mm512_mul_pd(gmi, _mm512_loadu_pd(mass + j));
+        __m512d s = _mm512_maskz_mul_pd(apart, gm, inv3);
+        accX = _mm512_add_pd(accX, _mm512_mul_pd(s, dx));
+        accY = _mm512_add_pd(accY, _mm512_mul_pd(s, dy));
+    }
+    double lanesX[8];
+    double lanesY[8];
+    _mm512_storeu_pd(lanesX, accX);
+    _mm512_storeu_pd(lanesY, accY);
+    fx += ((lanesX[0] + lanesX[1]) + (lanesX[2] + lanesX[3]))
+        + ((lanesX[4] + lanesX[5]) + (lanesX[6] + lanesX[7]));
+    fy += ((lanesY[0] + lanesY[1]) + (lanesY[2] + lanesY[3]))
+        + ((lanesY[4] + lanesY[5]) + (lanesY[6] + lanesY[7]));
+    forceScalar(xi, yi, mi, x, y, mass, j, end, fx, fy);
+}
+
+#endif // GRAVITY_X86
+
+} // namespace
+
+/**
+ *  Returns the widest level supported by both this build and the CPU.
+ */
+SimdLevel detectSimdLevel() noexcept
+{
+#if GRAVITY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+/**
+ *  Returns true if the provided level can run on this build and CPU.
+ */
+bool isSupported(SimdLevel level) noexcept
+{
+    return static_cast<int>(level) <= static_cast<int>(detectSimdLevel());
+}
+
+/**
+ *  Returns the kernel for the provided level.
+ */
+ForceKernel getForceKernel(SimdLevel level)
+{
+    if (!isSupported(level)) {
+        throw std::invalid_argument("SIMD level not supported on this CPU");
+    }
+    switch (level) {
+#if GRAVITY_X86
+    case SimdLevel::AVX512:
+        return forceAVX512;
+    case SimdLevel::AVX2:
+        return forceAVX2;
+    case SimdLevel::SSE2:
+        return forceSSE2;
+#endif
+    default:
+        return forceScalar;
+    }
+}
+
+} // namespace gravity
@@ -0,0 +1,72 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ *  Maps the named file read-only. The descriptor is closed right away;
+ *  the mapping keeps the file alive.
+ */
+MappedFile::MappedFile(const char* filename)
+    : bytes(nullptr)
+    , length(0)
+{
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), std::string("open ") + filename);
+    }
+    struct stat info {
+    };
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), std::string("stat ") + filename);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length != 0) {
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(
+                error, std::generic_category(), std::string("mmap ") + filename);
+        }
+        // The file is read front to back
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(mapping);
+    }
+    ::close(fd);
+}
+
+/**
+ *  Unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+    if (bytes) {
+        ::munmap(const_cast<char*>(bytes), length);
+    }
+}
+
+/**
+ *  Returns the first byte of the file, or nullptr if it is empty.
+ */
+const char* MappedFile::data() const noexcept
+{
+    return bytes;
+}
+
+/**
+ *  Returns the size of the file in bytes.
+ */
+size_t MappedFile::size() const noexcept
+{
+    return length;
+}
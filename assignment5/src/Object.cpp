@@ -1,19 +1,63 @@
 /* @author G. Hemingway, copyright 2020 - All rights reserved */
 #include "Object.h"
-#include "Universe.h"
+#include "BodyRef.h"
+#include "Gravity.h"
+#include "ObjectPool.h"
+#include "SymbolTable.h"
 #include "Visitor.h"
 
+namespace {
+
+/**
+ *  Number of Objects carved out of one slab.
+ */
+const size_t OBJECTS_PER_SLAB = 256;
+
+/**
+ *  Returns the pool, created on first use so that it outlives Objects
+ *  made during static initialization.
+ */
+ObjectPool& pool()
+{
+    static ObjectPool instance(sizeof(Object), OBJECTS_PER_SLAB);
+    return instance;
+}
+
+} // namespace
+
+/**
+ *  Interns the name and initializes an object with the provided
+ *  properties.
+ */
+Object::Object(std::string_view name, double mass, const vector2& pos, const vector2& vel)
+    : Object(symbols::intern(name), mass, pos, vel)
+{
+}
+
 /**
  *  Initializes an object with the provided properties.
  */
-Object::Object(const std::string& name, double mass, const vector2& pos, const vector2& vel)
-    : name(name)
+Object::Object(uint32_t nameId, double mass, const vector2& pos, const vector2& vel)
+    : name(nameId)
     , mass(mass)
     , position(pos)
     , velocity(vel)
+    , store(nullptr)
+    , slot(0)
+    , parent(nullptr)
 {
 }
 
+/**
+ *  Turns this object into a proxy for the body in slot of store, or
+ *  detaches it when store is nullptr.
+ */
+void Object::bind(BodyStore* store, uint32_t slot) noexcept
+{
+    this->store = store;
+    this->slot = slot;
+}
+
 /**
  *  An entry point for a visitor.
  */
@@ -30,7 +74,7 @@ void Object::accept(Visitor& visitor)
 Object* Object::clone() const
 {
     // TODO -- you fill in here.
-    return new Object(*this);
+    return new Object(getNameId(), getMass(), getPosition(), getVelocity());
 }
 
 /**
@@ -38,15 +82,23 @@ Object* Object::clone() const
  */
 double Object::getMass() const noexcept
 {
-    return mass;
+    return store ? BodyRef(*store, slot).getMass() : mass;
 }
 
 /**
  *  Returns the name.
  */
-std::string Object::getName() const noexcept
+std::string_view Object::getName() const noexcept
 {
-    return name;
+    return symbols::lookup(getNameId());
+}
+
+/**
+ *  Returns the id of the name.
+ */
+uint32_t Object::getNameId() const noexcept
+{
+    return store ? BodyRef(*store, slot).getNameId() : name;
 }
 
 /**
@@ -54,7 +106,7 @@ std::string Object::getName() const noexcept
  */
 vector2 Object::getPosition() const noexcept
 {
-    return position;
+    return store ? BodyRef(*store, slot).getPosition() : position;
 }
 
 /**
@@ -62,7 +114,7 @@ vector2 Object::getPosition() const noexcept
  */
 vector2 Object::getVelocity() const noexcept
 {
-    return velocity;
+    return store ? BodyRef(*store, slot).getVelocity() : velocity;
 }
 
 /**
@@ -72,10 +124,12 @@ vector2 Object::getVelocity() const noexcept
  */
 vector2 Object::getForce(const Object& rhs) const noexcept
 {
-    double distSq = (rhs.getPosition() - getPosition()).normSq();
-    double mag = (Universe::G * getMass() * rhs.getMass()) / distSq;
-    vector2 dir = (rhs.getPosition() - getPosition()).normalize();
-    return mag * dir;
+    vector2 lhsPos = getPosition();
+    vector2 rhsPos = rhs.getPosition();
+    vector2 force;
+    gravity::addPairForce(
+        lhsPos[0], lhsPos[1], getMass(), rhsPos[0], rhsPos[1], rhs.getMass(), force[0], force[1]);
+    return force;
 }
 
 /**
@@ -83,7 +137,11 @@ vector2 Object::getForce(const Object& rhs) const noexcept
  */
 void Object::setPosition(const vector2& pos)
 {
-    position = pos;
+    if (store) {
+        BodyRef(*store, slot).setPosition(pos);
+    } else {
+        position = pos;
+    }
 }
 
 /**
@@ -91,7 +149,19 @@ void Object::setPosition(const vector2& pos)
  */
 void Object::setVelocity(const vector2& vel)
 {
-    velocity = vel;
+    if (store) {
+        BodyRef(*store, slot).setVelocity(vel);
+    } else {
+        velocity = vel;
+    }
+}
+
+/**
+ *  Returns the composite this object is a member of.
+ */
+CompositeObject* Object::getParent() const noexcept
+{
+    return parent;
 }
 
 /**
@@ -100,7 +170,7 @@ void Object::setVelocity(const vector2& vel)
 bool Object::operator==(const Object& rhs) const
 {
     // TODO -- you fill in here.
-    return name == rhs.name; //&& mass == rhs.mass && position == rhs.position
+    return getNameId() == rhs.getNameId(); //&& mass == rhs.mass && position == rhs.position
         //&& velocity == rhs.velocity;
 }
 
@@ -113,3 +183,31 @@ bool Object::operator!=(const Object& rhs) const
     return !(*this == rhs);
 
 }
+
+/**
+ *  Allocates from the pool unless a subclass needs a larger block.
+ */
+void* Object::operator new(size_t size)
+{
+    return size <= pool().getBlockSize() ? pool().allocate() : ::operator new(size);
+}
+
+/**
+ *  Returns the block to the pool or to the global allocator.
+ */
+void Object::operator delete(void* ptr, size_t size) noexcept
+{
+    if (size <= pool().getBlockSize()) {
+        pool().deallocate(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
+/**
+ *  Returns the pool Objects are allocated from.
+ */
+const ObjectPool& Object::getPool()
+{
+    return pool();
+}
@@ -1,6 +1,8 @@
 /* @author G. Hemingway, copyright 2020 - All rights reserved */
 #include "ObjectFactory.h"
+#include "CompositeObject.h"
 #include "Object.h"
+#include "SymbolTable.h"
 #include "Universe.h"
 
 /**
@@ -8,7 +10,7 @@
  * will be assigned to everything except for name.
  */
 Object* ObjectFactory::makeObject(
-    std::string name, double mass, const vector2& pos, const vector2& vel)
+    std::string_view name, double mass, const vector2& pos, const vector2& vel)
 {
     // TODO -- you fill in here by creating an Object with the given
     // parameters and adding it to the Universe singleton.
@@ -16,3 +18,28 @@ Object* ObjectFactory::makeObject(
     return Universe::instance()->addObject(new Object(name, mass, pos, vel));
 
 }
+
+/**
+ * Creates an Object named by an interned id and adds it to the Universe.
+ */
+Object* ObjectFactory::makeObject(
+    uint32_t nameId, double mass, const vector2& pos, const vector2& vel)
+{
+    return Universe::instance()->addObject(new Object(nameId, mass, pos, vel));
+}
+
+/**
+ * Creates an empty composite and registers it with the Universe.
+ */
+CompositeObject* ObjectFactory::makeComposite(std::string_view name)
+{
+    return Universe::instance()->addComposite(new CompositeObject(symbols::intern(name), true));
+}
+
+/**
+ * Makes room in the singleton Universe for count more objects.
+ */
+void ObjectFactory::reserve(uint32_t count)
+{
+    Universe::instance()->reserve(count);
+}
@@ -0,0 +1,105 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "ObjectPool.h"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ *  Rounds size up to a multiple of the alignment the global operator new
+ *  guarantees, so that every block of a slab is as aligned as the slab.
+ */
+size_t alignedSize(size_t size)
+{
+    const size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    return (std::max(size, sizeof(void*)) + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+/**
+ *  Creates an empty pool.
+ */
+ObjectPool::ObjectPool(size_t blockSize, size_t blocksPerSlab)
+    : blockSize(alignedSize(blockSize))
+    , blocksPerSlab(std::max<size_t>(blocksPerSlab, 1))
+{
+}
+
+/**
+ *  The slabs are released by their owning pointers.
+ */
+ObjectPool::~ObjectPool() = default;
+
+/**
+ *  Pops the free list, first threading a new slab onto it if it is
+ *  empty.
+ */
+void* ObjectPool::allocate()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeList == nullptr) {
+        slabs.emplace_back(new char[blockSize * blocksPerSlab]);
+        char* slab = slabs.back().get();
+        for (size_t i = blocksPerSlab; i-- > 0;) {
+            auto* block = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    ++count;
+    ++allocations;
+    return block;
+}
+
+/**
+ *  Pushes the block onto the free list.
+ */
+void ObjectPool::deallocate(void* block) noexcept
+{
+    if (block == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList;
+    freeList = freed;
+    --count;
+}
+
+/**
+ *  Returns the size of a block in bytes.
+ */
+size_t ObjectPool::getBlockSize() const noexcept
+{
+    return blockSize;
+}
+
+/**
+ *  Returns the number of live blocks.
+ */
+uint64_t ObjectPool::getCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+/**
+ *  Returns the number of slabs.
+ */
+uint64_t ObjectPool::getSlabCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return slabs.size();
+}
+
+/**
+ *  Returns the number of calls to allocate().
+ */
+uint64_t ObjectPool::getAllocationCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocations;
+}
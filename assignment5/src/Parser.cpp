@@ -1,49 +1,283 @@
 /* @author G. Hemingway, copyright 2020 - All rights reserved */
 #include "Parser.h"
+#include "MappedFile.h"
 #include "ObjectFactory.h"
+#include "SymbolTable.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
 #include <cstring>
-#include <fstream>
-#include <iostream>
-#include <memory>
-#include <sstream>
-#include <string>
+#include <exception>
+#include <thread>
+#include <vector>
 
-double Parser::getDouble()
+namespace {
+
+/**
+ *  Characters that separate the tokens of a line. Tabs and carriage
+ *  returns are accepted as blanks too.
+ */
+constexpr std::string_view DELIMS = "{}[], \t\r";
+
+/**
+ *  Smallest chunk worth handing to a thread of its own, in bytes.
+ */
+constexpr size_t MIN_CHUNK = 64 << 10;
+
+/**
+ *  Number of records the serial parser collects before adding them, so
+ *  that their names can be interned as a batch.
+ */
+constexpr size_t RECORD_BATCH = 1024;
+
+/**
+ *  Returns the next token of text at or after pos and moves pos past it.
+ *  The token is empty when the line has no more tokens.
+ */
+std::string_view nextToken(std::string_view text, size_t& pos)
+{
+    size_t begin = text.find_first_not_of(DELIMS, pos);
+    if (begin == std::string_view::npos) {
+        pos = text.size();
+        return text.substr(pos);
+    }
+    size_t end = text.find_first_of(DELIMS, begin);
+    if (end == std::string_view::npos) {
+        end = text.size();
+    }
+    pos = end;
+    return text.substr(begin, end - begin);
+}
+
+/**
+ *  Returns the 1-based column of token within text.
+ */
+uint32_t columnOf(std::string_view text, std::string_view token)
+{
+    return static_cast<uint32_t>(token.data() - text.data()) + 1;
+}
+
+} // namespace
+
+ParseError::ParseError(uint32_t line, uint32_t column, const std::string& message)
+    : std::runtime_error("line " + std::to_string(line) + ", column " + std::to_string(column)
+          + ": " + message)
+    , line(line)
+    , column(column)
+{
+}
+
+/**
+ *  Returns the line the error was found on.
+ */
+uint32_t ParseError::getLine() const noexcept
 {
-    std::stringstream s(std::strtok(nullptr, delims()));
-    double d;
-    s >> d;
-    return d;
+    return line;
 }
 
+/**
+ *  Returns the column the error was found at.
+ */
+uint32_t ParseError::getColumn() const noexcept
+{
+    return column;
+}
+
+/**
+ *  Maps the script and loads it.
+ */
 void Parser::loadFile(const char* filename)
 {
-    std::ifstream file(filename);
-    if (file.fail()) {
-        std::cout << "Parser not able to open file: " << filename << std::endl;
-        exit(-1);
-    }
-
-    while (!file.eof()) {
-        // read an entire line into memory
-        std::string line;
-        if (std::getline(file, line)) {
-            // Copy string to char*
-            std::unique_ptr<char[]> data(new char[line.length()]);
-            std::copy(line.begin(), line.end(), data.get());
-            // Now tokenize
-            char* token = std::strtok(data.get(), delims());
-            std::string name(token);
-            double mass = getDouble();
-            vector2 pos;
-            vector2 vel;
-            pos[0] = getDouble();
-            pos[1] = getDouble();
-            vel[0] = getDouble();
-            vel[1] = getDouble();
-            // Make a happy object
-            ObjectFactory::makeObject(name, mass, pos, vel);
+    MappedFile file(filename);
+    load(file.data(), file.size());
+}
+
+/**
+ *  Adds a body for every line that is not blank. Small scripts, or a
+ *  single thread, are parsed straight into the Universe.
+ */
+void Parser::load(const char* data, size_t size)
+{
+    unsigned chunks = static_cast<unsigned>(std::min<size_t>(threads, size / MIN_CHUNK));
+    if (chunks > 1) {
+        loadChunks(data, size, chunks);
+        return;
+    }
+    std::vector<Record> batch;
+    batch.reserve(RECORD_BATCH);
+    try {
+        parseLines(data, data + size, 1, [&batch](const Record& record) {
+            batch.push_back(record);
+            if (batch.size() == RECORD_BATCH) {
+                addRecords(batch.data(), batch.size());
+                batch.clear();
+            }
+        });
+    } catch (...) {
+        addRecords(batch.data(), batch.size());
+        throw;
+    }
+    addRecords(batch.data(), batch.size());
+}
+
+/**
+ *  Interns the names, then creates the bodies by name id.
+ */
+void Parser::addRecords(const Record* records, size_t count)
+{
+    std::vector<std::string_view> names(count);
+    std::vector<uint32_t> ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        names[i] = records[i].name;
+    }
+    symbols::intern(names.data(), count, ids.data());
+    for (size_t i = 0; i < count; ++i) {
+        ObjectFactory::makeObject(ids[i], records[i].mass, records[i].pos, records[i].vel);
+    }
+}
+
+/**
+ *  Walks [begin, end) line by line. Nothing is allocated per line.
+ */
+template <typename Sink>
+void Parser::parseLines(const char* begin, const char* end, uint32_t firstLine, Sink&& sink)
+{
+    Record record;
+    for (uint32_t line = firstLine; begin < end; ++line) {
+        auto eol = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        if (eol == nullptr) {
+            eol = end;
         }
+        if (parseLine(std::string_view(begin, eol - begin), line, record)) {
+            sink(record);
+        }
+        begin = eol + 1;
+    }
+}
+
+/**
+ *  Splits the script into chunks that end at line breaks. A first pass
+ *  counts the lines of every chunk so that the second, which parses the
+ *  chunks into records, can number its lines. The records are then added
+ *  in file order. A chunk that fails keeps the records before the error,
+ *  and the first failing chunk's error is thrown once those and all
+ *  earlier chunks' bodies have been added, as the serial parser would.
+ */
+void Parser::loadChunks(const char* data, size_t size, unsigned chunks)
+{
+    const char* end = data + size;
+    std::vector<const char*> bounds(chunks + 1, end);
+    bounds[0] = data;
+    for (unsigned chunk = 1; chunk < chunks; ++chunk) {
+        const char* split = std::max(data + size / chunks * chunk, bounds[chunk - 1]);
+        auto eol = static_cast<const char*>(std::memchr(split, '\n', end - split));
+        bounds[chunk] = eol ? eol + 1 : end;
+    }
+
+    ThreadPool pool(chunks);
+    std::vector<uint32_t> firstLines(chunks + 1, 1);
+    pool.parallelFor(chunks, [&bounds, &firstLines](uint32_t begin, uint32_t last, unsigned) {
+        for (uint32_t chunk = begin; chunk < last; ++chunk) {
+            firstLines[chunk + 1]
+                = static_cast<uint32_t>(std::count(bounds[chunk], bounds[chunk + 1], '\n'));
+        }
+    });
+    for (unsigned chunk = 0; chunk < chunks; ++chunk) {
+        firstLines[chunk + 1] += firstLines[chunk];
+    }
+
+    std::vector<std::vector<Record>> records(chunks);
+    std::vector<std::exception_ptr> errors(chunks);
+    pool.parallelFor(chunks, [&](uint32_t begin, uint32_t last, unsigned) {
+        for (uint32_t chunk = begin; chunk < last; ++chunk) {
+            try {
+                parseLines(bounds[chunk], bounds[chunk + 1], firstLines[chunk],
+                    [&records, chunk](const Record& record) { records[chunk].push_back(record); });
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (const auto& chunk : records) {
+        total += chunk.size();
+    }
+    ObjectFactory::reserve(static_cast<uint32_t>(total));
+    for (unsigned chunk = 0; chunk < chunks; ++chunk) {
+        addRecords(records[chunk].data(), records[chunk].size());
+        if (errors[chunk]) {
+            std::rethrow_exception(errors[chunk]);
+        }
+    }
+}
+
+/**
+ *  Sets the number of threads that parse a script.
+ */
+void Parser::setThreadCount(unsigned threads)
+{
+    this->threads = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+}
+
+/**
+ *  Returns the number of threads that parse a script.
+ */
+unsigned Parser::getThreadCount() const
+{
+    return threads;
+}
+
+/**
+ *  Parses "{name, mass, [x y], [vx vy]}". Any run of the delimiters
+ *  separates two tokens, so only the order of the fields matters.
+ */
+bool Parser::parseLine(std::string_view text, uint32_t line, Record& record)
+{
+    static const char* const fields[] = { "mass", "x position", "y position", "x velocity",
+        "y velocity" };
+    size_t pos = 0;
+    record.name = nextToken(text, pos);
+    if (record.name.empty()) {
+        return false;
+    }
+    double values[5];
+    for (int i = 0; i < 5; ++i) {
+        std::string_view token = nextToken(text, pos);
+        if (token.empty()) {
+            throw ParseError(
+                line, static_cast<uint32_t>(text.size()) + 1, std::string("missing ") + fields[i]);
+        }
+        values[i] = parseNumber(token, line, columnOf(text, token));
+    }
+    std::string_view extra = nextToken(text, pos);
+    if (!extra.empty()) {
+        throw ParseError(
+            line, columnOf(text, extra), "unexpected '" + std::string(extra) + "' after the body");
+    }
+    record.mass = values[0];
+    record.pos[0] = values[1];
+    record.pos[1] = values[2];
+    record.vel[0] = values[3];
+    record.vel[1] = values[4];
+    return true;
+}
+
+/**
+ *  Parses a whole token as a double with std::from_chars. A leading '+'
+ *  is accepted, as it was by the stream based parser.
+ */
+double Parser::parseNumber(std::string_view token, uint32_t line, uint32_t column)
+{
+    const char* begin = token.data();
+    const char* end = begin + token.size();
+    if (token.size() > 1 && *begin == '+' && begin[1] != '-') {
+        ++begin;
+    }
+    double value = 0;
+    auto result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc() || result.ptr != end) {
+        throw ParseError(line, column, "invalid number '" + std::string(token) + "'");
     }
-    file.close();
+    return value;
 }
@@ -0,0 +1,232 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Gravity.h"
+#include "QuadTree.h"
+
+/**
+ *  Creates an empty tree with the provided opening angle.
+ */
+QuadTree::QuadTree(double theta)
+    : theta(0)
+    , x(nullptr)
+    , y(nullptr)
+    , mass(nullptr)
+    , count(0)
+{
+    setOpeningAngle(theta);
+}
+
+/**
+ *  Sets the opening angle. Must not be negative.
+ */
+void QuadTree::setOpeningAngle(double theta)
+{
+    if (!(theta >= 0)) {
+        throw std::invalid_argument("opening angle must not be negative");
+    }
+    this->theta = theta;
+}
+
+/**
+ *  Returns the opening angle.
+ */
+double QuadTree::getOpeningAngle() const noexcept
+{
+    return theta;
+}
+
+/**
+ *  Returns the number of nodes in the current tree.
+ */
+uint32_t QuadTree::nodeCount() const noexcept
+{
+    return static_cast<uint32_t>(nodes.size());
+}
+
+/**
+ *  Rebuilds the tree over the provided bodies. The root cell is the
+ *  smallest square enclosing all of them.
+ */
+void QuadTree::build(const double* x, const double* y, const double* mass, uint32_t count)
+{
+    this->x = x;
+    this->y = y;
+    this->mass = mass;
+    this->count = count;
+    nodes.clear();
+    next.resize(count);
+
+    double minX = 0;
+    double maxX = 0;
+    double minY = 0;
+    double maxY = 0;
+    if (count > 0) {
+        auto rangeX = std::minmax_element(x, x + count);
+        auto rangeY = std::minmax_element(y, y + count);
+        minX = *rangeX.first;
+        maxX = *rangeX.second;
+        minY = *rangeY.first;
+        maxY = *rangeY.second;
+    }
+    double half = std::max(maxX - minX, maxY - minY) / 2;
+    if (half == 0) {
+        half = 1;
+    }
+    nodes.push_back(Node { (minX + maxX) / 2, (minY + maxY) / 2, half, 0, 0, 0, 0, NONE, 0 });
+
+    for (uint32_t body = 0; body < count; ++body) {
+        insert(body);
+    }
+    summarize();
+}
+
+/**
+ *  Calculates the force experienced by the body at index by walking the
+ *  tree depth first and opening every cell that fails the size over
+ *  distance criterion or contains the body itself.
+ */
+vector2 QuadTree::getForce(uint32_t index) const
+{
+    const double xi = x[index];
+    const double yi = y[index];
+    const double mi = mass[index];
+    const double thetaSq = theta * theta;
+    double fx = 0;
+    double fy = 0;
+
+    // Each level pushes four children and pops one, bounding the depth.
+    uint32_t stack[3 * MAX_DEPTH + 4];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (node.mass == 0) {
+            continue;
+        }
+        if (node.firstChild == 0) {
+            for (uint32_t body = node.firstBody; body != NONE; body = next[body]) {
+                if (body != index) {
+                    gravity::addPairForce(xi, yi, mi, x[body], y[body], mass[body], fx, fy);
+                }
+            }
+            continue;
+        }
+        double dx = node.comX - xi;
+        double dy = node.comY - yi;
+        double size = 2 * node.half;
+        bool inside = std::abs(xi - node.centerX) <= node.half
+            && std::abs(yi - node.centerY) <= node.half;
+        if (!inside && size * size < thetaSq * (dx * dx + dy * dy)) {
+            gravity::addPairForce(xi, yi, mi, node.comX, node.comY, node.mass, fx, fy);
+        } else {
+            for (uint32_t child = 0; child < 4; ++child) {
+                stack[top++] = node.firstChild + child;
+            }
+        }
+    }
+
+    vector2 force;
+    force[0] = fx;
+    force[1] = fy;
+    return force;
+}
+
+/**
+ *  Descends from the root to the leaf covering body and stores it there,
+ *  splitting occupied leaves until the body gets a cell of its own.
+ */
+void QuadTree::insert(uint32_t body)
+{
+    uint32_t node = 0;
+    uint32_t depth = 0;
+    while (true) {
+        if (nodes[node].firstChild != 0) {
+            node = nodes[node].firstChild + quadrant(nodes[node], body);
+            ++depth;
+            continue;
+        }
+        Node& leaf = nodes[node];
+        uint32_t other = leaf.firstBody;
+        if (leaf.count == 0 || depth >= MAX_DEPTH
+            || (x[other] == x[body] && y[other] == y[body])) {
+            next[body] = leaf.firstBody;
+            leaf.firstBody = body;
+            ++leaf.count;
+            return;
+        }
+        subdivide(node);
+    }
+}
+
+/**
+ *  Turns a leaf into an internal cell with four empty children and moves
+ *  its bodies down one level.
+ */
+void QuadTree::subdivide(uint32_t node)
+{
+    const auto first = static_cast<uint32_t>(nodes.size());
+    const double half = nodes[node].half / 2;
+    const double centerX = nodes[node].centerX;
+    const double centerY = nodes[node].centerY;
+    for (uint32_t q = 0; q < 4; ++q) {
+        nodes.push_back(Node { centerX + ((q & 1) ? half : -half),
+            centerY + ((q & 2) ? half : -half), half, 0, 0, 0, 0, NONE, 0 });
+    }
+
+    Node& parent = nodes[node];
+    parent.firstChild = first;
+    uint32_t body = parent.firstBody;
+    while (body != NONE) {
+        uint32_t following = next[body];
+        Node& child = nodes[first + quadrant(parent, body)];
+        next[body] = child.firstBody;
+        child.firstBody = body;
+        ++child.count;
+        body = following;
+    }
+    parent.firstBody = NONE;
+    parent.count = 0;
+}
+
+/**
+ *  Returns the index of the child of node that covers body.
+ */
+uint32_t QuadTree::quadrant(const Node& node, uint32_t body) const
+{
+    return (x[body] >= node.centerX ? 1u : 0u) | (y[body] >= node.centerY ? 2u : 0u);
+}
+
+/**
+ *  Computes the mass and center of mass of every cell. Children always
+ *  live after their parent in the pool, so a single reverse sweep visits
+ *  every cell after all of its descendants.
+ */
+void QuadTree::summarize()
+{
+    for (size_t n = nodes.size(); n-- > 0;) {
+        Node& node = nodes[n];
+        double m = 0;
+        double mx = 0;
+        double my = 0;
+        if (node.firstChild == 0) {
+            for (uint32_t body = node.firstBody; body != NONE; body = next[body]) {
+                m += mass[body];
+                mx += mass[body] * x[body];
+                my += mass[body] * y[body];
+            }
+        } else {
+            for (uint32_t child = 0; child < 4; ++child) {
+                const Node& sub = nodes[node.firstChild + child];
+                m += sub.mass;
+                mx += sub.mass * sub.comX;
+                my += sub.mass * sub.comY;
+            }
+        }
+        node.mass = m;
+        node.comX = m != 0 ? mx / m : node.centerX;
+        node.comY = m != 0 ? my / m : node.centerY;
+    }
+}
@@ -0,0 +1,163 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "SnapshotFile.h"
+#include "BodyStore.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace snapshot {
+namespace {
+
+const char MAGIC[8] = { 'N', 'B', 'O', 'D', 'Y', 'S', 'N', 'P' };
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t count;
+    uint64_t nameBytes;
+};
+
+static_assert(sizeof(Header) == 32, "columns must start 8 byte aligned");
+
+/**
+ *  Returns the size of a snapshot of count bodies with nameBytes of names.
+ */
+uint64_t fileSize(uint64_t count, uint64_t nameBytes)
+{
+    return sizeof(Header) + count * 6 * sizeof(double) + nameBytes;
+}
+
+/**
+ *  Writes count doubles starting at column.
+ */
+void writeColumn(std::ofstream& out, const std::vector<double>& column)
+{
+    out.write(reinterpret_cast<const char*>(column.data()),
+        static_cast<std::streamsize>(column.size() * sizeof(double)));
+}
+
+/**
+ *  Copies count doubles starting at bytes into column.
+ */
+const char* readColumn(const char* bytes, uint64_t count, std::vector<double>& column)
+{
+    column.resize(count);
+    std::memcpy(column.data(), bytes, count * sizeof(double));
+    return bytes + count * sizeof(double);
+}
+
+} // namespace
+
+/**
+ *  Writes the header, the columns and the string table to filename.tmp
+ *  and renames it over filename.
+ */
+void save(const BodyStore& bodies, const char* filename)
+{
+    Header header {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.count = bodies.size();
+    std::vector<uint64_t> nameEnd(bodies.size());
+    for (uint32_t i = 0; i < bodies.size(); ++i) {
+        header.nameBytes += bodies.getName(i).size();
+        nameEnd[i] = header.nameBytes;
+    }
+
+    const std::string temp = std::string(filename) + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeColumn(out, bodies.mass);
+        writeColumn(out, bodies.x);
+        writeColumn(out, bodies.y);
+        writeColumn(out, bodies.vx);
+        writeColumn(out, bodies.vy);
+        out.write(reinterpret_cast<const char*>(nameEnd.data()),
+            static_cast<std::streamsize>(nameEnd.size() * sizeof(uint64_t)));
+        for (uint32_t i = 0; i < bodies.size(); ++i) {
+            const std::string_view name = bodies.getName(i);
+            out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        }
+        out.flush();
+        if (!out) {
+            int error = errno;
+            std::remove(temp.c_str());
+            throw std::system_error(error, std::generic_category(), "write " + temp);
+        }
+    }
+    if (std::rename(temp.c_str(), filename) != 0) {
+        int error = errno;
+        std::remove(temp.c_str());
+        throw std::system_error(error, std::generic_category(), std::string("rename ") + filename);
+    }
+}
+
+/**
+ *  Validates the header against the size of the mapping, then copies the
+ *  columns out of it into a new store which replaces bodies.
+ */
+void load(const char* filename, BodyStore& bodies)
+{
+    MappedFile file(filename);
+    Header header {};
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error(std::string(filename) + " is not a snapshot");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error(std::string(filename) + " is not a snapshot");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error(std::string(filename) + " was written with another byte order");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error(std::string(filename) + " has unsupported snapshot version "
+            + std::to_string(header.version));
+    }
+    if (header.count > UINT32_MAX || header.nameBytes > file.size()
+        || fileSize(header.count, header.nameBytes) != file.size()) {
+        throw std::runtime_error(std::string(filename) + " is truncated or corrupt");
+    }
+
+    const uint64_t count = header.count;
+    BodyStore loaded;
+    const char* bytes = file.data() + sizeof(Header);
+    bytes = readColumn(bytes, count, loaded.mass);
+    bytes = readColumn(bytes, count, loaded.x);
+    bytes = readColumn(bytes, count, loaded.y);
+    bytes = readColumn(bytes, count, loaded.vx);
+    bytes = readColumn(bytes, count, loaded.vy);
+    std::vector<uint64_t> nameEnd(count);
+    std::memcpy(nameEnd.data(), bytes, count * sizeof(uint64_t));
+    const char* names = bytes + count * sizeof(uint64_t);
+    std::vector<std::string_view> nameViews(count);
+    uint64_t begin = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (nameEnd[i] < begin || nameEnd[i] > header.nameBytes) {
+            throw std::runtime_error(std::string(filename) + " is truncated or corrupt");
+        }
+        nameViews[i] = std::string_view(names + begin, nameEnd[i] - begin);
+        begin = nameEnd[i];
+    }
+    loaded.names.resize(count);
+    symbols::intern(nameViews.data(), count, loaded.names.data());
+    loaded.nextX = loaded.x;
+    loaded.nextY = loaded.y;
+    loaded.nextVX = loaded.vx;
+    loaded.nextVY = loaded.vy;
+    loaded.revision = bodies.revision + 1;
+    std::swap(bodies, loaded);
+}
+
+} // namespace snapshot
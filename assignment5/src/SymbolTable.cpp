@@ -0,0 +1,252 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "SymbolTable.h"
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace symbols {
+namespace {
+
+/**
+ *  Ids are split into a page and an index within the page. Pages are
+ *  allocated as the table grows and never move, so lookup() only has to
+ *  load the page pointer.
+ */
+const uint32_t PAGE_BITS = 16;
+const uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+const uint32_t PAGE_COUNT = 1u << (32 - PAGE_BITS);
+
+/**
+ *  Size of the blocks the characters of short strings are packed into.
+ */
+const size_t ARENA_BLOCK = 64 << 10;
+
+/**
+ *  Every string is stored as its length followed by its characters, so
+ *  that a single pointer locates it.
+ */
+typedef uint32_t Length;
+
+std::string_view viewOf(const char* stored) noexcept
+{
+    Length length;
+    std::memcpy(&length, stored, sizeof(length));
+    return std::string_view(stored + sizeof(length), length);
+}
+
+/**
+ *  The strings, an index to find the id of a string and the pages to find
+ *  the string of an id.
+ */
+struct Table {
+    Table()
+    {
+        slots.resize(1024);
+        add(std::string_view(), std::hash<std::string_view>()(std::string_view()));
+    }
+
+    /**
+     *  Returns the id of text, or none if it has not been interned. Must
+     *  hold mutex.
+     */
+    std::optional<uint32_t> find(std::string_view text, size_t hash) const
+    {
+        const uint32_t tag = tagOf(hash);
+        for (size_t i = hash & (slots.size() - 1);; i = (i + 1) & (slots.size() - 1)) {
+            if (slots[i].id == 0) {
+                return std::nullopt;
+            }
+            if (slots[i].tag == tag && viewOf(slots[i].stored) == text) {
+                return slots[i].id - 1;
+            }
+        }
+    }
+
+    /**
+     *  Stores a copy of text under the next id. Must hold mutex.
+     */
+    uint32_t add(std::string_view text, size_t hash)
+    {
+        const uint32_t id = count.load(std::memory_order_relaxed);
+        if (id == UINT32_MAX - 1 || text.size() > UINT32_MAX) {
+            throw std::length_error("symbol table is full");
+        }
+        const char** page = pages[id >> PAGE_BITS].load(std::memory_order_relaxed);
+        if (page == nullptr) {
+            page = new const char*[PAGE_SIZE];
+            pages[id >> PAGE_BITS].store(page, std::memory_order_release);
+        }
+        const char* stored = store(text);
+        page[id & (PAGE_SIZE - 1)] = stored;
+        if (2 * (id + 1) > slots.size()) {
+            rehash();
+        }
+        insertSlot(Slot { id + 1, tagOf(hash), stored }, hash);
+        count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    /**
+     *  Copies the length and characters of text into the arena and
+     *  returns where they start.
+     */
+    const char* store(std::string_view text)
+    {
+        const size_t bytes = sizeof(Length) + text.size();
+        char* copy;
+        if (bytes > ARENA_BLOCK / 4) {
+            blocks.emplace_back(new char[bytes]);
+            copy = blocks.back().get();
+        } else {
+            if (bytes > arenaLeft) {
+                arena.emplace_back(new char[ARENA_BLOCK]);
+                arenaNext = arena.back().get();
+                arenaLeft = ARENA_BLOCK;
+            }
+            copy = arenaNext;
+            arenaNext += bytes;
+            arenaLeft -= bytes;
+        }
+        const auto length = static_cast<Length>(text.size());
+        std::memcpy(copy, &length, sizeof(length));
+        std::memcpy(copy + sizeof(length), text.data(), text.size());
+        return copy;
+    }
+
+    /**
+     *  Index entry of a string: its id + 1, zero marking an empty slot,
+     *  bits of its hash that filter out most mismatches without touching
+     *  the characters, and where it is stored.
+     */
+    struct Slot {
+        uint32_t id;
+        uint32_t tag;
+        const char* stored;
+    };
+
+    void insertSlot(const Slot& slot, size_t hash)
+    {
+        size_t i = hash & (slots.size() - 1);
+        while (slots[i].id != 0) {
+            i = (i + 1) & (slots.size() - 1);
+        }
+        slots[i] = slot;
+    }
+
+    /**
+     *  Doubles the index and reinserts every entry.
+     */
+    void rehash()
+    {
+        std::vector<Slot> old(2 * slots.size());
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.id != 0) {
+                insertSlot(slot, std::hash<std::string_view>()(viewOf(slot.stored)));
+            }
+        }
+    }
+
+    /**
+     *  Returns the bits of a hash kept in a slot.
+     */
+    static uint32_t tagOf(size_t hash) noexcept
+    {
+        return static_cast<uint32_t>(uint64_t(hash) >> 32) ^ static_cast<uint32_t>(hash);
+    }
+
+    std::mutex mutex;
+
+    /**
+     *  Own the stored strings. Short ones are packed into arena blocks,
+     *  long ones get a block of their own; neither ever moves.
+     */
+    std::vector<std::unique_ptr<char[]>> arena;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* arenaNext = nullptr;
+    size_t arenaLeft = 0;
+
+    /**
+     *  Open addressing index, at most half full.
+     */
+    std::vector<Slot> slots;
+
+    std::atomic<const char**> pages[PAGE_COUNT] = {};
+    std::atomic<uint32_t> count { 0 };
+};
+
+/**
+ *  Returns the table. It is created on first use and deliberately never
+ *  destroyed, so that names stay readable from destructors that run at
+ *  exit.
+ */
+Table& table()
+{
+    static Table* instance = new Table();
+    return *instance;
+}
+
+} // namespace
+
+/**
+ *  Looks text up under the lock and adds it if it is missing.
+ */
+uint32_t intern(std::string_view text)
+{
+    const size_t hash = std::hash<std::string_view>()(text);
+    Table& symbols = table();
+    std::lock_guard<std::mutex> lock(symbols.mutex);
+    std::optional<uint32_t> found = symbols.find(text, hash);
+    return found ? *found : symbols.add(text, hash);
+}
+
+/**
+ *  Hashes every text first, then looks them up under one lock while
+ *  prefetching the index slot of the text PREFETCH_DISTANCE ahead, so
+ *  that the cache misses of a large table overlap.
+ */
+void intern(const std::string_view* texts, size_t count, uint32_t* ids)
+{
+    const size_t PREFETCH_DISTANCE = 8;
+    std::vector<size_t> hashes(count);
+    for (size_t i = 0; i < count; ++i) {
+        hashes[i] = std::hash<std::string_view>()(texts[i]);
+    }
+    Table& symbols = table();
+    std::lock_guard<std::mutex> lock(symbols.mutex);
+    for (size_t i = 0; i < count; ++i) {
+#if defined(__GNUC__)
+        if (i + PREFETCH_DISTANCE < count) {
+            __builtin_prefetch(
+                &symbols.slots[hashes[i + PREFETCH_DISTANCE] & (symbols.slots.size() - 1)]);
+        }
+#endif
+        std::optional<uint32_t> found = symbols.find(texts[i], hashes[i]);
+        ids[i] = found ? *found : symbols.add(texts[i], hashes[i]);
+    }
+}
+
+/**
+ *  Reads the slot of id in its page.
+ */
+std::string_view lookup(uint32_t id) noexcept
+{
+    return viewOf(
+        table().pages[id >> PAGE_BITS].load(std::memory_order_acquire)[id & (PAGE_SIZE - 1)]);
+}
+
+/**
+ *  Returns the number of interned strings.
+ */
+uint32_t size() noexcept
+{
+    return table().count.load(std::memory_order_acquire);
+}
+
+} // namespace symbols
@@ -0,0 +1,129 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "ThreadPool.h"
+
+/**
+ *  Creates a pool with the provided number of participants, the calling
+ *  thread included.
+ */
+ThreadPool::ThreadPool(unsigned threads)
+    : generation(0)
+    , pending(0)
+    , stopping(false)
+    , count(0)
+    , trampoline(nullptr)
+    , body(nullptr)
+{
+    for (unsigned worker = 1; worker < threads; ++worker) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+/**
+ *  Stops and joins every worker.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ *  Returns the number of participants, the calling thread included.
+ */
+unsigned ThreadPool::size() const noexcept
+{
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+/**
+ *  Returns the first index of the chunk of [0, count) owned by worker.
+ */
+uint32_t ThreadPool::chunkBegin(uint32_t count, unsigned worker, unsigned size) noexcept
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(count) * worker / size);
+}
+
+/**
+ *  Publishes a loop to the workers, runs chunk zero on the calling thread
+ *  and waits for the others.
+ */
+void ThreadPool::run(uint32_t count, Trampoline trampoline, void* body)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->count = count;
+        this->trampoline = trampoline;
+        this->body = body;
+        error = nullptr;
+        pending = static_cast<unsigned>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+/**
+ *  Runs the chunk of the current loop owned by worker, recording the
+ *  first exception instead of letting it escape.
+ */
+void ThreadPool::runChunk(unsigned worker) noexcept
+{
+    uint32_t begin = chunkBegin(count, worker, size());
+    uint32_t end = chunkBegin(count, worker + 1, size());
+    if (begin == end) {
+        return;
+    }
+    try {
+        trampoline(body, begin, end, worker);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+}
+
+/**
+ *  Body of every worker thread: sleep until a new loop is published, run
+ *  this worker's chunk and report back.
+ */
+void ThreadPool::workerLoop(unsigned worker)
+{
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runChunk(worker);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = --pending == 0;
+        }
+        if (last) {
+            done.notify_one();
+        }
+    }
+}
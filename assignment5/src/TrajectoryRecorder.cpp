@@ -0,0 +1,254 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "TrajectoryRecorder.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace {
+
+const char MAGIC[8] = { 'N', 'B', 'O', 'D', 'Y', 'T', 'R', 'J' };
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+};
+
+struct FrameHeader {
+    uint64_t step;
+    uint64_t count;
+};
+
+static_assert(sizeof(Header) == 16 && sizeof(FrameHeader) == 16,
+    "columns must start 8 byte aligned");
+
+/**
+ *  How long the writer thread sleeps when the ring is empty. Polling
+ *  keeps the simulation thread free of any notification.
+ */
+const std::chrono::microseconds IDLE_WAIT(200);
+
+/**
+ *  Returns the smallest power of two not below bytes.
+ */
+uint64_t ringSize(size_t bytes)
+{
+    uint64_t size = 1;
+    while (size < bytes) {
+        size <<= 1;
+    }
+    return size;
+}
+
+/**
+ *  Copies count doubles starting at bytes into column.
+ */
+const char* readColumn(const char* bytes, uint64_t count, std::vector<double>& column)
+{
+    column.resize(count);
+    std::memcpy(column.data(), bytes, count * sizeof(double));
+    return bytes + count * sizeof(double);
+}
+
+} // namespace
+
+/**
+ *  Opens the file, writes its header and starts the writer thread.
+ */
+TrajectoryRecorder::TrajectoryRecorder(const char* filename, uint64_t interval, size_t bufferBytes)
+    : interval(interval)
+    , mask(ringSize(bufferBytes) - 1)
+{
+    if (interval == 0 || bufferBytes == 0) {
+        throw std::invalid_argument("trajectory interval and buffer size must be positive");
+    }
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    Header header {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        throw std::system_error(errno, std::generic_category(), std::string("write ") + filename);
+    }
+    ring.reset(new char[mask + 1]);
+    writer = std::thread(&TrajectoryRecorder::writerLoop, this);
+}
+
+/**
+ *  Lets the writer thread drain the ring and waits for it.
+ */
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+}
+
+/**
+ *  Reserves room for the frame past head, copies it in and publishes the
+ *  new head. The frame is dropped if the writer thread has not yet freed
+ *  enough of the ring.
+ */
+void TrajectoryRecorder::onStep(uint64_t step, const BodyStore& bodies)
+{
+    if (step % interval != 0) {
+        return;
+    }
+    const uint64_t count = bodies.size();
+    const uint64_t column = count * sizeof(double);
+    const uint64_t bytes = sizeof(FrameHeader) + 4 * column;
+    const uint64_t at = head.load(std::memory_order_relaxed);
+    if (at + bytes - tail.load(std::memory_order_acquire) > mask + 1) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const FrameHeader frame { step, count };
+    put(at, &frame, sizeof(frame));
+    put(at + sizeof(frame), bodies.x.data(), column);
+    put(at + sizeof(frame) + column, bodies.y.data(), column);
+    put(at + sizeof(frame) + 2 * column, bodies.vx.data(), column);
+    put(at + sizeof(frame) + 3 * column, bodies.vy.data(), column);
+    head.store(at + bytes, std::memory_order_release);
+    recorded.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ *  Waits until the writer thread has flushed up to the current head.
+ */
+void TrajectoryRecorder::flush()
+{
+    const uint64_t target = head.load(std::memory_order_relaxed);
+    while (flushed.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(IDLE_WAIT);
+    }
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error) {
+        std::exception_ptr first = error;
+        error = nullptr;
+        std::rethrow_exception(first);
+    }
+}
+
+/**
+ *  Returns the number of frames buffered.
+ */
+uint64_t TrajectoryRecorder::getRecorded() const noexcept
+{
+    return recorded.load(std::memory_order_relaxed);
+}
+
+/**
+ *  Returns the number of frames dropped.
+ */
+uint64_t TrajectoryRecorder::getDropped() const noexcept
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ *  Validates the header, then walks the frames of a memory mapping of
+ *  the file.
+ */
+std::vector<TrajectoryRecorder::Frame> TrajectoryRecorder::read(const char* filename)
+{
+    MappedFile file(filename);
+    Header header {};
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error(std::string(filename) + " is not a trajectory");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error(std::string(filename) + " is not a trajectory");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error(std::string(filename) + " was written with another byte order");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error(std::string(filename) + " has unsupported trajectory version "
+            + std::to_string(header.version));
+    }
+
+    std::vector<Frame> frames;
+    uint64_t offset = sizeof(Header);
+    while (file.size() - offset >= sizeof(FrameHeader)) {
+        FrameHeader frameHeader {};
+        std::memcpy(&frameHeader, file.data() + offset, sizeof(frameHeader));
+        const uint64_t count = frameHeader.count;
+        if (count > (file.size() - offset - sizeof(FrameHeader)) / (4 * sizeof(double))) {
+            break;
+        }
+        Frame frame;
+        frame.step = frameHeader.step;
+        const char* bytes = file.data() + offset + sizeof(FrameHeader);
+        bytes = readColumn(bytes, count, frame.x);
+        bytes = readColumn(bytes, count, frame.y);
+        bytes = readColumn(bytes, count, frame.vx);
+        readColumn(bytes, count, frame.vy);
+        frames.push_back(std::move(frame));
+        offset += sizeof(FrameHeader) + 4 * count * sizeof(double);
+    }
+    return frames;
+}
+
+/**
+ *  Streams published frames to the file, flushing whenever it catches up
+ *  with the simulation, until asked to stop with nothing left to write.
+ */
+void TrajectoryRecorder::writerLoop()
+{
+    while (true) {
+        const bool stop = stopping.load(std::memory_order_acquire);
+        const uint64_t from = tail.load(std::memory_order_relaxed);
+        const uint64_t to = head.load(std::memory_order_acquire);
+        if (from != to) {
+            drain(from, to);
+            tail.store(to, std::memory_order_release);
+            continue;
+        }
+        if (flushed.load(std::memory_order_relaxed) != to) {
+            out.flush();
+            if (!out) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::make_exception_ptr(
+                        std::system_error(errno, std::generic_category(), "write trajectory"));
+                }
+            }
+            flushed.store(to, std::memory_order_release);
+        }
+        if (stop) {
+            return;
+        }
+        std::this_thread::sleep_for(IDLE_WAIT);
+    }
+}
+
+/**
+ *  Copies bytes into the ring, in two pieces if they wrap.
+ */
+void TrajectoryRecorder::put(uint64_t at, const void* data, size_t bytes) noexcept
+{
+    const uint64_t begin = at & mask;
+    const uint64_t first = std::min<uint64_t>(bytes, mask + 1 - begin);
+    std::memcpy(ring.get() + begin, data, first);
+    std::memcpy(ring.get(), static_cast<const char*>(data) + first, bytes - first);
+}
+
+/**
+ *  Writes the ring between two absolute offsets, in two pieces if they
+ *  wrap.
+ */
+void TrajectoryRecorder::drain(uint64_t from, uint64_t to)
+{
+    const uint64_t begin = from & mask;
+    const uint64_t first = std::min<uint64_t>(to - from, mask + 1 - begin);
+    out.write(ring.get() + begin, static_cast<std::streamsize>(first));
+    out.write(ring.get(), static_cast<std::streamsize>(to - from - first));
+}
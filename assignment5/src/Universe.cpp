@@ -1,9 +1,45 @@
 /* @author G. Hemingway, copyright 2020 - All rights reserved */
 #include "Universe.h"
+#include "CompositeObject.h"
 #include "Object.h"
+#include "SnapshotFile.h"
+#include "SymbolTable.h"
+#include "Visitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
 
 Universe* Universe::inst = nullptr;
 
+namespace {
+
+/**
+ *  Substep weights of Yoshida's fourth order composition of leapfrog.
+ */
+const double YOSHIDA_W1 = 1.0 / (2.0 - std::cbrt(2.0));
+const double YOSHIDA_W0 = -std::cbrt(2.0) * YOSHIDA_W1;
+
+/**
+ *  Returns the shorter of speed / accel and accel / jerk, ignoring terms
+ *  that are not defined.
+ */
+double timescaleOf(double speed, double accel, double jerk)
+{
+    if (accel == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double timescale = speed / accel;
+    if (jerk > 0) {
+        timescale = std::min(timescale, accel / jerk);
+    }
+    return timescale;
+}
+
+} // namespace
+
 /**
  *  Returns the only (singleton) instance of the Universe.
  */
@@ -22,6 +58,7 @@ Universe* Universe::instance()
 Universe::~Universe()
 {
     // TODO -- you fill in here.
+    releaseComposites();
     release(objects);
     //inst is packed by unique_ptr so not delete inst just set this nullptr
     inst = nullptr;
@@ -36,9 +73,51 @@ Object* Universe::addObject(Object* ptr)
 {
     // TODO -- you fill in here.
     objects.add(ptr);
+    ptr->bind(&bodies,
+        bodies.add(ptr->getNameId(), ptr->getMass(), ptr->getPosition(), ptr->getVelocity()));
+    compositesChanged();
     return ptr;
 }
 
+/**
+ *  Registers a composite with the Universe.
+ */
+CompositeObject* Universe::addComposite(CompositeObject* ptr)
+{
+    composites.add(ptr);
+    compositesChanged();
+    return ptr;
+}
+
+/**
+ *  Marks the hierarchy of the composites as changed.
+ */
+void Universe::compositesChanged()
+{
+    compositeTreeValid = false;
+    accelValid = false;
+}
+
+/**
+ *  Deletes the registered composites. They do not own their members.
+ */
+void Universe::releaseComposites()
+{
+    for (auto composite : composites) {
+        delete composite;
+    }
+    composites.clear();
+    compositesChanged();
+}
+
+/**
+ *  Makes room for count more Objects in the packed store.
+ */
+void Universe::reserve(uint32_t count)
+{
+    bodies.reserve(bodies.size() + count);
+}
+
 /**
  *  Returns the begin iterator to the actual Objects. The order of
  *  itetarion will be the same as that over getSnapshot()'s result as
@@ -85,8 +164,7 @@ Universe::const_iterator Universe::end() const
 
 /**
  *  Returns a container of copies of all the Objects registered with the
- *  Universe. This snapshot should be used as the source of data for
- *  computing the next step in the simulation.
+ *  Universe. The copies are detached from the Universe's state.
  */
 ArrayList<Object*> Universe::getSnapshot() const
 {
@@ -117,31 +195,529 @@ ArrayList<Object*> Universe::getSnapshot() const
  *  assignment, you must assume that the first registered object is a
  *  "sun" and its position should not be affected by any of the other
  *  objects.
+ *
+ *  Every new state is computed from the front buffers only and written
+ *  to the back buffers, which are flipped in at the end. All updates
+ *  therefore appear simultaneous, exactly as with a snapshot, but no
+ *  Object is cloned and nothing is allocated.
  */
 void Universe::stepSimulation(const double& timeSec)
 {
-    ArrayList<Object*> copy(getSnapshot());
+    if (bodies.size() == 0) {
+        return;
+    }
+
+    switch (integrator) {
+    case Integrator::Leapfrog:
+        leapfrogStep(timeSec);
+        break;
+    case Integrator::Yoshida4:
+        leapfrogStep(YOSHIDA_W1 * timeSec);
+        leapfrogStep(YOSHIDA_W0 * timeSec);
+        leapfrogStep(YOSHIDA_W1 * timeSec);
+        break;
+    case Integrator::RK4:
+        rk4Step(timeSec);
+        break;
+    case Integrator::Block:
+        blockStep(timeSec);
+        break;
+    case Integrator::Euler:
+        eulerStep(timeSec);
+        break;
+    }
 
-    for (size_t obj1 = 1; obj1 < objects.size(); ++obj1) {
-        // Calculate a new force vector for each entity
+    ++stepCount;
+    if (checkpointer) {
+        checkpointer->onStep(stepCount, bodies);
+    }
+    if (recorder) {
+        recorder->onStep(stepCount, bodies);
+    }
+}
+
+/**
+ *  Advances the simulation by steps steps of timeSec.
+ */
+void Universe::run(uint64_t steps, double timeSec)
+{
+    for (uint64_t step = 0; step < steps; ++step) {
+        stepSimulation(timeSec);
+    }
+}
+
+/**
+ *  Writes the position of every body to positions, interleaved.
+ */
+void Universe::getPositions(double* positions) const
+{
+    for (uint32_t obj = 0; obj < bodies.size(); ++obj) {
+        positions[2 * obj] = bodies.x[obj];
+        positions[2 * obj + 1] = bodies.y[obj];
+    }
+}
+
+/**
+ *  Copies the state of the sun into the back buffers.
+ */
+void Universe::holdSun()
+{
+    bodies.nextX[0] = bodies.x[0];
+    bodies.nextY[0] = bodies.y[0];
+    bodies.nextVX[0] = bodies.vx[0];
+    bodies.nextVY[0] = bodies.vy[0];
+}
+
+/**
+ *  Moves every body with its velocity at the start of the step and then
+ *  updates the velocity from the force at the start of the step.
+ */
+void Universe::eulerStep(double timeSec)
+{
+    computeForces(bodies.x.data(), bodies.y.data());
+    holdSun();
+    forEachBody(1, bodies.size(),
+        [this, timeSec](uint32_t begin, uint32_t end) { integrate(begin, end, timeSec); });
+    bodies.flip();
+    accelValid = false;
+}
+
+/**
+ *  Calls body(begin, end) over [begin, end), split across the worker pool
+ *  when there is one.
+ */
+template <typename Body> void Universe::forEachBody(uint32_t begin, uint32_t end, Body&& body)
+{
+    if (!pool) {
+        body(begin, end);
+        return;
+    }
+    pool->parallelFor(end - begin, [begin, &body](uint32_t first, uint32_t last, unsigned) {
+        body(begin + first, begin + last);
+    });
+}
+
+/**
+ *  Computes the net force on every body but the sun at the provided
+ *  positions. Except for ForceMethod::Symmetric, each body sums its own
+ *  forces in a fixed order, so any partition of the bodies yields the
+ *  same bits.
+ */
+void Universe::computeForces(const double* x, const double* y)
+{
+    const uint32_t count = bodies.size();
+    const double* mass = bodies.mass.data();
+    forceX.resize(count);
+    forceY.resize(count);
+    forceX[0] = 0;
+    forceY[0] = 0;
+
+    switch (forceMethod) {
+    case ForceMethod::BarnesHut:
+        tree.build(x, y, mass, count);
+        forEachBody(1, count, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t obj1 = begin; obj1 < end; ++obj1) {
+                vector2 force = tree.getForce(obj1);
+                forceX[obj1] = force[0];
+                forceY[obj1] = force[1];
+            }
+        });
+        break;
+    case ForceMethod::Symmetric:
+        computeSymmetricForces(x, y);
+        break;
+    case ForceMethod::Composite:
+        buildCompositeTree();
+        compositeTree.update(x, y, mass);
+        forEachBody(1, count, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t obj1 = begin; obj1 < end; ++obj1) {
+                vector2 force = compositeTree.getForce(obj1);
+                forceX[obj1] = force[0];
+                forceY[obj1] = force[1];
+            }
+        });
+        break;
+    case ForceMethod::BruteForce:
+        forEachBody(1, count, [this, x, y, mass, count](uint32_t begin, uint32_t end) {
+            for (uint32_t obj1 = begin; obj1 < end; ++obj1) {
+                // Every body but obj1, in two contiguous runs
+                double fx = 0;
+                double fy = 0;
+                kernel(x[obj1], y[obj1], mass[obj1], x, y, mass, 0, obj1, fx, fy);
+                kernel(x[obj1], y[obj1], mass[obj1], x, y, mass, obj1 + 1, count, fx, fy);
+                forceX[obj1] = fx;
+                forceY[obj1] = fy;
+            }
+        });
+        break;
+    }
+}
+
+/**
+ *  Computes the net force on every body at the provided positions and
+ *  divides it into accelX and accelY. The sun gets no acceleration.
+ */
+void Universe::computeAccelerations(const double* x, const double* y)
+{
+    computeForces(x, y);
+    accelX.resize(bodies.size());
+    accelY.resize(bodies.size());
+    accelX[0] = 0;
+    accelY[0] = 0;
+    forEachBody(1, bodies.size(), [this](uint32_t begin, uint32_t end) {
+        for (uint32_t obj = begin; obj < end; ++obj) {
+            accelX[obj] = forceX[obj] / bodies.mass[obj];
+            accelY[obj] = forceY[obj] / bodies.mass[obj];
+        }
+    });
+}
+
+/**
+ *  Evaluates every pair (i, j) with i < j once and scatters the force to
+ *  i and its negation to j. Pairs with the sun are included so that it
+ *  pulls on every other body; the force it receives is dropped.
+ *
+ *  Rows get shorter as i grows, so row i is paired with row count - 1 - i
+ *  to give every unit of work the same number of pairs. With a worker
+ *  pool each thread scatters into its own block of partialX/partialY,
+ *  which are then summed body by body in thread order.
+ */
+void Universe::computeSymmetricForces(const double* x, const double* y)
+{
+    const uint32_t count = bodies.size();
+    const double* mass = bodies.mass.data();
+    const uint32_t folds = (count + 1) / 2;
+    const unsigned threads = getThreadCount();
+
+    auto accumulate = [x, y, mass, count](uint32_t begin, uint32_t end, double* fx, double* fy) {
+        std::fill(fx, fx + count, 0.0);
+        std::fill(fy, fy + count, 0.0);
+        for (uint32_t fold = begin; fold < end; ++fold) {
+            uint32_t rows[2] = { fold, count - 1 - fold };
+            for (uint32_t i : rows) {
+                for (uint32_t j = i + 1; j < count; ++j) {
+                    double pairX = 0;
+                    double pairY = 0;
+                    gravity::addPairForce(x[i], y[i], mass[i], x[j], y[j], mass[j], pairX, pairY);
+                    fx[i] += pairX;
+                    fy[i] += pairY;
+                    fx[j] -= pairX;
+                    fy[j] -= pairY;
+                }
+                if (rows[0] == rows[1]) {
+                    break;
+                }
+            }
+        }
+    };
+
+    if (threads == 1) {
+        accumulate(0, folds, forceX.data(), forceY.data());
+    } else {
+        partialX.resize(static_cast<size_t>(threads) * count);
+        partialY.resize(static_cast<size_t>(threads) * count);
+        pool->parallelFor(folds, [this, &accumulate, count](uint32_t begin, uint32_t end,
+                                     unsigned worker) {
+            size_t offset = static_cast<size_t>(worker) * count;
+            accumulate(begin, end, partialX.data() + offset, partialY.data() + offset);
+        });
+        // Reduce in a fixed thread order. Threads that got no folds did
+        // not clear their block and are skipped.
+        forEachBody(0, count, [this, threads, folds, count](uint32_t begin, uint32_t end) {
+            for (uint32_t obj = begin; obj < end; ++obj) {
+                double fx = 0;
+                double fy = 0;
+                for (unsigned worker = 0; worker < threads; ++worker) {
+                    if (ThreadPool::chunkBegin(folds, worker, threads)
+                        == ThreadPool::chunkBegin(folds, worker + 1, threads)) {
+                        continue;
+                    }
+                    fx += partialX[static_cast<size_t>(worker) * count + obj];
+                    fy += partialY[static_cast<size_t>(worker) * count + obj];
+                }
+                forceX[obj] = fx;
+                forceY[obj] = fy;
+            }
+        });
+    }
+    forceX[0] = 0;
+    forceY[0] = 0;
+}
+
+/**
+ *  Computes the new state of the bodies in [begin, end) into the back
+ *  buffers from the front buffers and the net forces.
+ */
+void Universe::integrate(uint32_t begin, uint32_t end, double timeSec)
+{
+    const double* x = bodies.x.data();
+    const double* y = bodies.y.data();
+    const double* vx = bodies.vx.data();
+    const double* vy = bodies.vy.data();
+    const double* mass = bodies.mass.data();
+    double* nextX = bodies.nextX.data();
+    double* nextY = bodies.nextY.data();
+    double* nextVX = bodies.nextVX.data();
+    double* nextVY = bodies.nextVY.data();
+
+    for (uint32_t obj1 = begin; obj1 < end; ++obj1) {
         vector2 force;
+        force[0] = forceX[obj1];
+        force[1] = forceY[obj1];
+
+        vector2 accel = force / mass[obj1];
+        nextX[obj1] = x[obj1] + vx[obj1] * timeSec;
+        nextY[obj1] = y[obj1] + vy[obj1] * timeSec;
+        nextVX[obj1] = vx[obj1] + accel[0] * timeSec;
+        nextVY[obj1] = vy[obj1] + accel[1] * timeSec;
+    }
+}
+
+/**
+ *  Kicks the velocities by half a step with the current accelerations,
+ *  drifts the positions by a full step with the new velocities and kicks
+ *  again with the accelerations at the new positions. Those are kept for
+ *  the first kick of the next step, so a step costs one force evaluation
+ *  unless the positions or the force settings changed in between.
+ */
+void Universe::leapfrogStep(double timeSec)
+{
+    if (!accelValid || accelRevision != bodies.revision) {
+        computeAccelerations(bodies.x.data(), bodies.y.data());
+    }
+    holdSun();
+    const double halfStep = 0.5 * timeSec;
+
+    forEachBody(1, bodies.size(), [this, timeSec, halfStep](uint32_t begin, uint32_t end) {
+        for (uint32_t obj = begin; obj < end; ++obj) {
+            bodies.nextVX[obj] = bodies.vx[obj] + accelX[obj] * halfStep;
+            bodies.nextVY[obj] = bodies.vy[obj] + accelY[obj] * halfStep;
+            bodies.nextX[obj] = bodies.x[obj] + bodies.nextVX[obj] * timeSec;
+            bodies.nextY[obj] = bodies.y[obj] + bodies.nextVY[obj] * timeSec;
+        }
+    });
+
+    computeAccelerations(bodies.nextX.data(), bodies.nextY.data());
+    forEachBody(1, bodies.size(), [this, halfStep](uint32_t begin, uint32_t end) {
+        for (uint32_t obj = begin; obj < end; ++obj) {
+            bodies.nextVX[obj] += accelX[obj] * halfStep;
+            bodies.nextVY[obj] += accelY[obj] * halfStep;
+        }
+    });
+
+    bodies.flip();
+    accelValid = true;
+    accelRevision = bodies.revision;
+}
+
+/**
+ *  Classical Runge-Kutta step. The back buffers accumulate the weighted
+ *  sum of the four stage derivatives while stageX/Y and stageVX/VY hold
+ *  the state the next stage is evaluated at.
+ */
+void Universe::rk4Step(double timeSec)
+{
+    const uint32_t count = bodies.size();
+    stageX.resize(count);
+    stageY.resize(count);
+    stageVX.resize(count);
+    stageVY.resize(count);
+    stageX[0] = bodies.x[0];
+    stageY[0] = bodies.y[0];
+    holdSun();
+
+    // Stage 1 at the start of the step
+    computeAccelerations(bodies.x.data(), bodies.y.data());
+    forEachBody(1, count, [this, timeSec](uint32_t begin, uint32_t end) {
+        for (uint32_t obj = begin; obj < end; ++obj) {
+            bodies.nextX[obj] = bodies.x[obj] + bodies.vx[obj] * (timeSec / 6);
+            bodies.nextY[obj] = bodies.y[obj] + bodies.vy[obj] * (timeSec / 6);
+            bodies.nextVX[obj] = bodies.vx[obj] + accelX[obj] * (timeSec / 6);
+            bodies.nextVY[obj] = bodies.vy[obj] + accelY[obj] * (timeSec / 6);
+            stageX[obj] = bodies.x[obj] + bodies.vx[obj] * (timeSec / 2);
+            stageY[obj] = bodies.y[obj] + bodies.vy[obj] * (timeSec / 2);
+            stageVX[obj] = bodies.vx[obj] + accelX[obj] * (timeSec / 2);
+            stageVY[obj] = bodies.vy[obj] + accelY[obj] * (timeSec / 2);
+        }
+    });
+
+    // Stages 2 and 3 at the middle of the step, stage 4 at the end
+    const double weights[3] = { timeSec / 3, timeSec / 3, timeSec / 6 };
+    const double offsets[3] = { timeSec / 2, timeSec, 0 };
+    for (int stage = 0; stage < 3; ++stage) {
+        const double weight = weights[stage];
+        const double offset = offsets[stage];
+        computeAccelerations(stageX.data(), stageY.data());
+        forEachBody(1, count, [this, weight, offset](uint32_t begin, uint32_t end) {
+            for (uint32_t obj = begin; obj < end; ++obj) {
+                bodies.nextX[obj] += stageVX[obj] * weight;
+                bodies.nextY[obj] += stageVY[obj] * weight;
+                bodies.nextVX[obj] += accelX[obj] * weight;
+                bodies.nextVY[obj] += accelY[obj] * weight;
+                stageX[obj] = bodies.x[obj] + stageVX[obj] * offset;
+                stageY[obj] = bodies.y[obj] + stageVY[obj] * offset;
+                stageVX[obj] = bodies.vx[obj] + accelX[obj] * offset;
+                stageVY[obj] = bodies.vy[obj] + accelY[obj] * offset;
+            }
+        });
+    }
+
+    bodies.flip();
+    accelValid = false;
+}
+
+/**
+ *  Hierarchical leapfrog. The step is divided into 2^maxBlockLevel ticks
+ *  and a body at level k is kicked every 2^(maxBlockLevel - k) ticks.
+ *  Between two ticks at which some body is due every body drifts, which
+ *  is cheap; forces are only computed for the bodies that are due. A
+ *  body may only move to a level whose steps start at the current tick,
+ *  so at the last tick every body is due and the state is synchronized.
+ */
+void Universe::blockStep(double timeSec)
+{
+    const uint32_t count = bodies.size();
+    if (!accelValid || accelRevision != bodies.revision || blockTimescale.size() != count) {
+        computeAccelerations(bodies.x.data(), bodies.y.data());
+        blockTimescale.resize(count);
+        for (uint32_t obj = 1; obj < count; ++obj) {
+            blockTimescale[obj] = timescaleOf(std::hypot(bodies.vx[obj], bodies.vy[obj]),
+                std::hypot(accelX[obj], accelY[obj]), 0);
+        }
+    }
+    const uint64_t end = uint64_t(1) << maxBlockLevel;
+    const double tickSec = timeSec / static_cast<double>(end);
+    blockLevels.assign(count, 0);
+    blockDue.assign(count, end);
+
+    // Open the first step of every body
+    for (uint32_t obj = 1; obj < count; ++obj) {
+        unsigned level = chooseBlockLevel(blockTimescale[obj], timeSec, 0);
+        double halfStep = 0.5 * std::ldexp(timeSec, -static_cast<int>(level));
+        bodies.vx[obj] += accelX[obj] * halfStep;
+        bodies.vy[obj] += accelY[obj] * halfStep;
+        blockLevels[obj] = level;
+        blockDue[obj] = end >> level;
+    }
+
+    uint64_t now = 0;
+    while (now < end) {
+        const uint64_t next = *std::min_element(blockDue.begin(), blockDue.end());
+        const double span = static_cast<double>(next - now) * tickSec;
+        forEachBody(1, count, [this, span](uint32_t begin, uint32_t last) {
+            for (uint32_t obj = begin; obj < last; ++obj) {
+                bodies.x[obj] += bodies.vx[obj] * span;
+                bodies.y[obj] += bodies.vy[obj] * span;
+            }
+        });
+        now = next;
 
-        for (size_t obj2 = 0; obj2 < objects.size(); ++obj2) {
-            if (obj1 != obj2)
-                force += objects[obj1]->getForce(*objects[obj2]);
+        active.clear();
+        for (uint32_t obj = 1; obj < count; ++obj) {
+            if (blockDue[obj] == now) {
+                active.push_back(obj);
+            }
         }
+        computeActiveForces();
+
+        // Close the step of every due body and open its next one
+        forEachBody(0, static_cast<uint32_t>(active.size()),
+            [this, timeSec, now, end](uint32_t begin, uint32_t last) {
+                for (uint32_t i = begin; i < last; ++i) {
+                    const uint32_t obj = active[i];
+                    const double step = std::ldexp(timeSec, -static_cast<int>(blockLevels[obj]));
+                    const double ax = forceX[obj] / bodies.mass[obj];
+                    const double ay = forceY[obj] / bodies.mass[obj];
+                    const double jerk = std::hypot(ax - accelX[obj], ay - accelY[obj]) / step;
+                    bodies.vx[obj] += ax * (0.5 * step);
+                    bodies.vy[obj] += ay * (0.5 * step);
+                    accelX[obj] = ax;
+                    accelY[obj] = ay;
+                    blockTimescale[obj] = timescaleOf(
+                        std::hypot(bodies.vx[obj], bodies.vy[obj]), std::hypot(ax, ay), jerk);
+                    if (now == end) {
+                        continue;
+                    }
+                    unsigned level = chooseBlockLevel(blockTimescale[obj], timeSec, now);
+                    double halfStep = 0.5 * std::ldexp(timeSec, -static_cast<int>(level));
+                    bodies.vx[obj] += ax * halfStep;
+                    bodies.vy[obj] += ay * halfStep;
+                    blockLevels[obj] = level;
+                    blockDue[obj] = now + (end >> level);
+                }
+            });
+    }
 
-        vector2 accel = force / objects[obj1]->getMass();
-        vector2 oldPos = objects[obj1]->getPosition();
-        vector2 oldVel = objects[obj1]->getVelocity();
-        vector2 newPos = oldPos + oldVel * timeSec;
-        vector2 newVel = oldVel + accel * timeSec;
+    accelValid = true;
+    accelRevision = bodies.revision;
+}
 
-        copy[obj1]->setVelocity(newVel);
-        copy[obj1]->setPosition(newPos);
+/**
+ *  Computes the net force on the bodies listed in active. Symmetric
+ *  cannot share pairs with bodies that are not due, so it sums per body
+ *  like BruteForce here.
+ */
+void Universe::computeActiveForces()
+{
+    const uint32_t count = bodies.size();
+    const double* x = bodies.x.data();
+    const double* y = bodies.y.data();
+    const double* mass = bodies.mass.data();
+    forceX.resize(count);
+    forceY.resize(count);
+
+    if (forceMethod == ForceMethod::BarnesHut) {
+        tree.build(x, y, mass, count);
+        forEachBody(0, static_cast<uint32_t>(active.size()), [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                vector2 force = tree.getForce(active[i]);
+                forceX[active[i]] = force[0];
+                forceY[active[i]] = force[1];
+            }
+        });
+        return;
     }
+    if (forceMethod == ForceMethod::Composite) {
+        buildCompositeTree();
+        compositeTree.update(x, y, mass);
+        forEachBody(0, static_cast<uint32_t>(active.size()), [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                vector2 force = compositeTree.getForce(active[i]);
+                forceX[active[i]] = force[0];
+                forceY[active[i]] = force[1];
+            }
+        });
+        return;
+    }
+    forEachBody(0, static_cast<uint32_t>(active.size()),
+        [this, x, y, mass, count](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const uint32_t obj1 = active[i];
+                double fx = 0;
+                double fy = 0;
+                kernel(x[obj1], y[obj1], mass[obj1], x, y, mass, 0, obj1, fx, fy);
+                kernel(x[obj1], y[obj1], mass[obj1], x, y, mass, obj1 + 1, count, fx, fy);
+                forceX[obj1] = fx;
+                forceY[obj1] = fy;
+            }
+        });
+}
 
-    swap(copy);
+/**
+ *  Returns the deepest of the level asked for by the time scale and the
+ *  shallowest level whose steps start at tick.
+ */
+unsigned Universe::chooseBlockLevel(double timescale, double timeSec, uint64_t tick) const
+{
+    const double wanted = blockAccuracy * timescale;
+    unsigned level = 0;
+    while (level < maxBlockLevel && std::ldexp(timeSec, -static_cast<int>(level)) > wanted) {
+        ++level;
+    }
+    while (tick % (uint64_t(1) << (maxBlockLevel - level)) != 0) {
+        ++level;
+    }
+    return level;
 }
 
 /**
@@ -153,10 +729,147 @@ void Universe::swap(ArrayList<Object*>& snapshot)
     // TODO -- you fill in here.
     // release(objects);
     // objects = snapshot;
+    // Members of a composite are owned by it, not by the Universe
+    for (auto object : snapshot) {
+        if (object->getParent() != nullptr) {
+            throw std::invalid_argument("cannot swap in members of a composite");
+        }
+    }
+    releaseComposites();
     objects.swap(snapshot);
+    // Load the incoming Objects into the packed store and make them proxies
+    bodies.clear();
+    for (auto object : objects) {
+        object->bind(&bodies,
+            bodies.add(object->getNameId(), object->getMass(), object->getPosition(),
+                object->getVelocity()));
+    }
     release(snapshot);
 }
 
+/**
+ *  Writes the packed state to a snapshot file.
+ */
+void Universe::save(const char* filename) const
+{
+    snapshot::save(bodies, filename);
+}
+
+/**
+ *  Loads the packed state straight from the snapshot and creates a proxy
+ *  for every body. The proxies hold no state of their own, so they are
+ *  created without copying names.
+ */
+void Universe::load(const char* filename)
+{
+    snapshot::load(filename, bodies);
+    releaseComposites();
+    release(objects);
+    objects.reserve(bodies.size());
+    for (uint32_t slot = 0; slot < bodies.size(); ++slot) {
+        Object* object = new Object(symbols::EMPTY, 0, vector2(), vector2());
+        object->bind(&bodies, slot);
+        objects.add(object);
+    }
+    accelValid = false;
+}
+
+/**
+ *  Starts writing checkpoints on a background thread.
+ */
+void Universe::setCheckpointing(const std::string& prefix, uint64_t interval, unsigned retention)
+{
+    // Construct first so that rejected settings keep the current ones
+    std::unique_ptr<Checkpointer> next(new Checkpointer(prefix, interval, retention, stepCount));
+    checkpointer = std::move(next);
+}
+
+/**
+ *  Writes the last pending checkpoint and stops checkpointing.
+ */
+void Universe::stopCheckpointing()
+{
+    checkpointer.reset();
+}
+
+/**
+ *  Blocks until every checkpoint due so far is on disk.
+ */
+void Universe::flushCheckpoints()
+{
+    if (checkpointer) {
+        checkpointer->flush();
+    }
+}
+
+/**
+ *  Loads the newest checkpoint for prefix that can be read.
+ */
+uint64_t Universe::resume(const std::string& prefix)
+{
+    std::vector<uint64_t> steps = Checkpointer::list(prefix);
+    for (auto step = steps.rbegin(); step != steps.rend(); ++step) {
+        try {
+            load(Checkpointer::pathFor(prefix, *step).c_str());
+        } catch (const std::exception&) {
+            continue;
+        }
+        stepCount = *step;
+        return stepCount;
+    }
+    return 0;
+}
+
+/**
+ *  Returns the number of steps taken.
+ */
+uint64_t Universe::getStepCount() const
+{
+    return stepCount;
+}
+
+/**
+ *  Starts recording frames on a background thread.
+ */
+void Universe::setTrajectoryRecording(const char* filename, uint64_t interval, size_t bufferBytes)
+{
+    // The current frames go out before the file can be truncated again,
+    // and constructing first keeps the recording if the settings are rejected
+    if (recorder) {
+        recorder->flush();
+    }
+    std::unique_ptr<TrajectoryRecorder> next(
+        new TrajectoryRecorder(filename, interval, bufferBytes));
+    recorder = std::move(next);
+    recorder->onStep(stepCount, bodies);
+}
+
+/**
+ *  Writes the buffered frames and stops recording.
+ */
+void Universe::stopTrajectoryRecording()
+{
+    recorder.reset();
+}
+
+/**
+ *  Blocks until every recorded frame has been written.
+ */
+void Universe::flushTrajectory()
+{
+    if (recorder) {
+        recorder->flush();
+    }
+}
+
+/**
+ *  Returns the number of frames dropped by the current recording.
+ */
+uint64_t Universe::getDroppedFrames() const
+{
+    return recorder ? recorder->getDropped() : 0;
+}
+
 /**
  *  Call delete on each pointer and remove it from the container.
  */
@@ -168,3 +881,264 @@ void Universe::release(ArrayList<Object*>& objects)
     }
     objects.clear();
 }
+
+/**
+ *  Selects the strategy used by stepSimulation() to compute forces.
+ */
+void Universe::setForceMethod(ForceMethod method)
+{
+    forceMethod = method;
+    accelValid = false;
+}
+
+/**
+ *  Returns the strategy used by stepSimulation() to compute forces.
+ */
+Universe::ForceMethod Universe::getForceMethod() const
+{
+    return forceMethod;
+}
+
+/**
+ *  Sets the opening angle of both approximate force methods.
+ */
+void Universe::setOpeningAngle(double theta)
+{
+    tree.setOpeningAngle(theta);
+    compositeTree.setOpeningAngle(theta);
+    accelValid = false;
+}
+
+/**
+ *  Returns the opening angle.
+ */
+double Universe::getOpeningAngle() const
+{
+    return tree.getOpeningAngle();
+}
+
+/**
+ *  Returns the packed state of the registered Objects.
+ */
+const BodyStore& Universe::getBodies() const
+{
+    return bodies;
+}
+
+/**
+ *  Returns a handle onto the body in slot.
+ */
+BodyRef Universe::getBody(uint32_t slot)
+{
+    return BodyRef(bodies, slot);
+}
+
+/**
+ *  Sets the number of threads stepSimulation() spreads the bodies over.
+ */
+void Universe::setThreadCount(unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threads == getThreadCount()) {
+        return;
+    }
+    pool.reset(threads > 1 ? new ThreadPool(threads) : nullptr);
+    accelValid = false;
+}
+
+/**
+ *  Returns the number of threads used by stepSimulation().
+ */
+unsigned Universe::getThreadCount() const
+{
+    return pool ? pool->size() : 1;
+}
+
+/**
+ *  Selects the instruction set of the brute-force pairwise kernel.
+ */
+void Universe::setSimdLevel(gravity::SimdLevel level)
+{
+    kernel = gravity::getForceKernel(level);
+    simdLevel = level;
+    accelValid = false;
+}
+
+/**
+ *  Returns the instruction set of the brute-force pairwise kernel.
+ */
+gravity::SimdLevel Universe::getSimdLevel() const
+{
+    return simdLevel;
+}
+
+/**
+ *  Selects the scheme used by stepSimulation() to advance the bodies.
+ */
+void Universe::setIntegrator(Integrator scheme)
+{
+    integrator = scheme;
+}
+
+/**
+ *  Returns the scheme used by stepSimulation() to advance the bodies.
+ */
+Universe::Integrator Universe::getIntegrator() const
+{
+    return integrator;
+}
+
+/**
+ *  Returns the kinetic energy of every body but the sun plus the
+ *  potential energy of every pair.
+ */
+double Universe::getEnergy() const
+{
+    const uint32_t count = bodies.size();
+    double energy = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (i != 0) {
+            double speedSq = bodies.vx[i] * bodies.vx[i] + bodies.vy[i] * bodies.vy[i];
+            energy += 0.5 * bodies.mass[i] * speedSq;
+        }
+        for (uint32_t j = i + 1; j < count; ++j) {
+            double dx = bodies.x[j] - bodies.x[i];
+            double dy = bodies.y[j] - bodies.y[i];
+            double dist = std::sqrt(dx * dx + dy * dy);
+            if (dist > 0) {
+                energy -= G * bodies.mass[i] * bodies.mass[j] / dist;
+            }
+        }
+    }
+    return energy;
+}
+
+/**
+ *  Sets the accuracy parameter of Integrator::Block.
+ */
+void Universe::setBlockAccuracy(double eta)
+{
+    if (!(eta > 0)) {
+        throw std::invalid_argument("block accuracy must be positive");
+    }
+    blockAccuracy = eta;
+}
+
+/**
+ *  Returns the accuracy parameter of Integrator::Block.
+ */
+double Universe::getBlockAccuracy() const
+{
+    return blockAccuracy;
+}
+
+/**
+ *  Sets the deepest level of Integrator::Block.
+ */
+void Universe::setMaxBlockLevel(unsigned levels)
+{
+    if (levels > 32) {
+        throw std::invalid_argument("at most 32 block levels are supported");
+    }
+    maxBlockLevel = levels;
+}
+
+/**
+ *  Returns the deepest level of Integrator::Block.
+ */
+unsigned Universe::getMaxBlockLevel() const
+{
+    return maxBlockLevel;
+}
+
+/**
+ *  Returns the level every body used for its last block step.
+ */
+const std::vector<unsigned>& Universe::getBlockLevels() const
+{
+    return blockLevels;
+}
+
+/**
+ *  Visits the whole store in one span, or one chunk per worker when
+ *  there is a pool. Worker 0 visits with visitor itself and the other
+ *  workers' copies are merged in worker order.
+ */
+void Universe::visitAll(BatchVisitor& visitor)
+{
+    BodySpan span { 0, bodies.size(), bodies.names.data(), bodies.mass.data(), bodies.x.data(),
+        bodies.y.data(), bodies.vx.data(), bodies.vy.data() };
+    if (!pool) {
+        visitor.visit(span);
+        return;
+    }
+    std::vector<std::unique_ptr<BatchVisitor>> copies(pool->size());
+    for (size_t worker = 1; worker < copies.size(); ++worker) {
+        copies[worker] = visitor.split();
+    }
+    pool->parallelFor(bodies.size(), [&](uint32_t begin, uint32_t end, unsigned worker) {
+        BodySpan chunk = span;
+        chunk.begin = begin;
+        chunk.end = end;
+        if (worker == 0) {
+            visitor.visit(chunk);
+        } else {
+            copies[worker]->visit(chunk);
+        }
+    });
+    for (size_t worker = 1; worker < copies.size(); ++worker) {
+        visitor.merge(*copies[worker]);
+    }
+}
+
+/**
+ *  Returns the registered composites.
+ */
+const ArrayList<CompositeObject*>& Universe::getComposites() const
+{
+    return composites;
+}
+
+/**
+ *  Adds the bodies outside every composite at the top level, in slot
+ *  order, followed by the outermost composites in the order they were
+ *  made. The tree is only rebuilt after bodies or composites were added
+ *  or released, or a composite gained a member.
+ */
+void Universe::buildCompositeTree()
+{
+    if (compositeTreeValid) {
+        return;
+    }
+    compositeTree.clear(bodies.size());
+    for (auto object : objects) {
+        if (object->getParent() == nullptr) {
+            compositeTree.addBody(object->slot);
+        }
+    }
+    for (auto composite : composites) {
+        if (composite->getParent() == nullptr) {
+            addToCompositeTree(*composite);
+        }
+    }
+    compositeTreeValid = true;
+}
+
+/**
+ *  Adds object, or a group holding the members of a composite.
+ */
+void Universe::addToCompositeTree(const Object& object)
+{
+    auto composite = dynamic_cast<const CompositeObject*>(&object);
+    if (composite == nullptr) {
+        compositeTree.addBody(object.slot);
+        return;
+    }
+    const uint32_t group = compositeTree.openGroup();
+    for (const Object* child : composite->getChildren()) {
+        addToCompositeTree(*child);
+    }
+    compositeTree.closeGroup(group);
+}
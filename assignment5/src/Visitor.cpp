@@ -2,6 +2,8 @@
 #include "Visitor.h"
 #include "Object.h"
 
+#include <algorithm>
+
 /**
  *  Construct a visitor that prints to the provided ostream.
  */
@@ -19,3 +21,150 @@ void PrintVisitor::visit(Object& object)
     // TODO -- you fill in here.
     os << object.getName();
 }
+
+/**
+ *  Accumulates mass, momentum and kinetic energy over the span.
+ */
+void MomentumVisitor::visit(const BodySpan& span)
+{
+    double sumMass = 0;
+    double sumX = 0;
+    double sumY = 0;
+    double sumEnergy = 0;
+    for (uint32_t i = span.begin; i < span.end; ++i) {
+        const double m = span.mass[i];
+        sumMass += m;
+        sumX += m * span.vx[i];
+        sumY += m * span.vy[i];
+        sumEnergy += 0.5 * m * (span.vx[i] * span.vx[i] + span.vy[i] * span.vy[i]);
+    }
+    mass += sumMass;
+    momentumX += sumX;
+    momentumY += sumY;
+    kineticEnergy += sumEnergy;
+}
+
+/**
+ *  Returns an empty MomentumVisitor.
+ */
+std::unique_ptr<BatchVisitor> MomentumVisitor::split() const
+{
+    return std::make_unique<MomentumVisitor>();
+}
+
+/**
+ *  Adds the sums of other.
+ */
+void MomentumVisitor::merge(const BatchVisitor& other)
+{
+    const auto& rhs = dynamic_cast<const MomentumVisitor&>(other);
+    mass += rhs.mass;
+    momentumX += rhs.momentumX;
+    momentumY += rhs.momentumY;
+    kineticEnergy += rhs.kineticEnergy;
+}
+
+/**
+ *  Returns the total mass.
+ */
+double MomentumVisitor::getMass() const noexcept
+{
+    return mass;
+}
+
+/**
+ *  Returns the total momentum.
+ */
+vector2 MomentumVisitor::getMomentum() const noexcept
+{
+    vector2 momentum;
+    momentum[0] = momentumX;
+    momentum[1] = momentumY;
+    return momentum;
+}
+
+/**
+ *  Returns the total kinetic energy.
+ */
+double MomentumVisitor::getKineticEnergy() const noexcept
+{
+    return kineticEnergy;
+}
+
+/**
+ *  Grows the box to hold every body of the span.
+ */
+void BoundsVisitor::visit(const BodySpan& span)
+{
+    if (span.begin == span.end) {
+        return;
+    }
+    if (empty) {
+        minX = maxX = span.x[span.begin];
+        minY = maxY = span.y[span.begin];
+        empty = false;
+    }
+    for (uint32_t i = span.begin; i < span.end; ++i) {
+        minX = std::min(minX, span.x[i]);
+        maxX = std::max(maxX, span.x[i]);
+        minY = std::min(minY, span.y[i]);
+        maxY = std::max(maxY, span.y[i]);
+    }
+}
+
+/**
+ *  Returns an empty BoundsVisitor.
+ */
+std::unique_ptr<BatchVisitor> BoundsVisitor::split() const
+{
+    return std::make_unique<BoundsVisitor>();
+}
+
+/**
+ *  Grows the box to hold the box of other.
+ */
+void BoundsVisitor::merge(const BatchVisitor& other)
+{
+    const auto& rhs = dynamic_cast<const BoundsVisitor&>(other);
+    if (rhs.empty) {
+        return;
+    }
+    if (empty) {
+        *this = rhs;
+        return;
+    }
+    minX = std::min(minX, rhs.minX);
+    maxX = std::max(maxX, rhs.maxX);
+    minY = std::min(minY, rhs.minY);
+    maxY = std::max(maxY, rhs.maxY);
+}
+
+/**
+ *  Returns true if no body has been visited.
+ */
+bool BoundsVisitor::isEmpty() const noexcept
+{
+    return empty;
+}
+
+/**
+ *  Returns the lower left corner of the box.
+ */
+vector2 BoundsVisitor::getMin() const noexcept
+{
+    vector2 corner;
+    corner[0] = minX;
+    corner[1] = minY;
+    return corner;
+}
+
+/**
+ *  Returns the upper right corner of the box.
+ */
+vector2 BoundsVisitor::getMax() const noexcept
+{
+    vector2 corner;
+    corner[0] = maxX;
+    corner[1] = maxY;
+    return corner;
+}
@@ -0,0 +1,198 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "ArrayList.h"
+#include "GrowthPolicy.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * An element type that counts its live instances. Its copy constructor
+ * throws once throwAfter more copies have been made, and it has no move
+ * constructor, so the ArrayList has to copy it.
+ */
+struct Tracked {
+    static inline int live = 0;
+    static inline int throwAfter = -1;
+
+    explicit Tracked(int value = 0)
+        : value(value)
+    {
+        ++live;
+    }
+
+    Tracked(const Tracked& rhs)
+        : value(rhs.value)
+    {
+        if (throwAfter == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        if (throwAfter > 0) {
+            --throwAfter;
+        }
+        ++live;
+    }
+
+    Tracked& operator=(const Tracked& rhs) = default;
+
+    ~Tracked()
+    {
+        --live;
+    }
+
+    int value;
+};
+
+/**
+ * An element whose moves never throw and whose default constructor throws
+ * while failDefault is set, to fail filling the gap before an index past
+ * the end.
+ */
+struct GapFilled {
+    static inline bool failDefault = false;
+
+    GapFilled()
+    {
+        if (failDefault) {
+            throw std::runtime_error("default construction failed");
+        }
+    }
+
+    explicit GapFilled(std::string text)
+        : text(std::move(text))
+    {
+    }
+
+    GapFilled(const GapFilled& rhs) = default;
+    GapFilled(GapFilled&& rhs) noexcept = default;
+    GapFilled& operator=(const GapFilled& rhs) = default;
+    GapFilled& operator=(GapFilled&& rhs) noexcept = default;
+
+    std::string text;
+};
+
+// The fixture for testing the ArrayList with its growth and size parameters.
+class ArrayListTest : public ::testing::Test {
+protected:
+    // A list with a non-default policy and size type
+    template <typename T> using SmallList = ArrayList<T, HalfGrowth, uint16_t>;
+
+    void TearDown() override
+    {
+        Tracked::throwAfter = -1;
+        GapFilled::failDefault = false;
+    }
+};
+
+// Only the elements in the list are ever constructed
+TEST_F(ArrayListTest, OnlyLiveElements)
+{
+    Tracked::live = 0;
+    {
+        SmallList<Tracked> a;
+        for (int i = 0; i < 100; ++i) {
+            a.add(Tracked(i));
+        }
+        EXPECT_EQ(Tracked::live, 100);
+        a.remove(0);
+        a.add(10, Tracked(-1));
+        EXPECT_EQ(Tracked::live, 100);
+        EXPECT_EQ(a[10].value, -1);
+        EXPECT_EQ(a[11].value, 11);
+        a.add(uint16_t(120), Tracked(-2));
+        EXPECT_EQ(Tracked::live, 121);
+        a.clear();
+        EXPECT_EQ(Tracked::live, 0);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// A copy that throws while growing leaves the list unchanged
+TEST_F(ArrayListTest, StrongGuaranteeWhileGrowing)
+{
+    Tracked::live = 0;
+    {
+        SmallList<Tracked> a;
+        for (int i = 0; i < 4; ++i) {
+            a.add(Tracked(i));
+        }
+        const std::vector<Tracked> values(3, Tracked(-1));
+        const uint16_t capacity = a.capacity();
+        Tracked::throwAfter = 2;
+        EXPECT_THROW(a.add(Tracked(4)), std::runtime_error);
+        Tracked::throwAfter = 2;
+        EXPECT_THROW(a.add(1, Tracked(4)), std::runtime_error);
+        Tracked::throwAfter = 4;
+        EXPECT_THROW(a.insert(2, values.begin(), values.end()), std::runtime_error);
+        Tracked::throwAfter = -1;
+        EXPECT_EQ(a.capacity(), capacity);
+        ASSERT_EQ(a.size(), 4U);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(a[i].value, i);
+        }
+        EXPECT_EQ(Tracked::live, 7);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// Failing to fill the gap while growing leaves the elements in place
+TEST_F(ArrayListTest, StrongGuaranteeFillingGap)
+{
+    SmallList<GapFilled> a;
+    a.add(GapFilled(std::string(32, 'a')));
+    a.add(GapFilled(std::string(32, 'b')));
+    GapFilled::failDefault = true;
+    EXPECT_THROW(a.add(5, GapFilled("x")), std::runtime_error);
+    EXPECT_THROW(a.emplace(5, "x"), std::runtime_error);
+    const GapFilled values[] = { GapFilled("x"), GapFilled("y") };
+    EXPECT_THROW(a.insert(5, std::begin(values), std::end(values)), std::runtime_error);
+    GapFilled::failDefault = false;
+    ASSERT_EQ(a.size(), 2U);
+    EXPECT_EQ(a.capacity(), 2U);
+    EXPECT_EQ(a[0].text, std::string(32, 'a'));
+    EXPECT_EQ(a[1].text, std::string(32, 'b'));
+}
+
+// Adding an element of the list itself, with and without growing
+TEST_F(ArrayListTest, AddOwnElement)
+{
+    SmallList<std::string> a;
+    a.add(std::string(32, 'a'));
+    a.add(std::string(32, 'b'));
+    a.add(0, a[1]);
+    a.add(0, a[2]);
+    a.emplace(1, a[3]);
+    a.add(a[0]);
+    ASSERT_EQ(a.size(), 6U);
+    const char expected[] = "bbbabb";
+    for (uint16_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i], std::string(32, expected[i]));
+    }
+
+    ArrayList<long, DoublingGrowth, uint64_t> b;
+    b.add(7);
+    for (int i = 0; i < 5; ++i) {
+        b.add(0, b[b.size() - 1]);
+    }
+    EXPECT_EQ(b.size(), 6U);
+    EXPECT_EQ(b[0], 7);
+}
+
+// Move-only elements can be added and emplaced
+TEST_F(ArrayListTest, MoveOnlyElements)
+{
+    SmallList<std::unique_ptr<int>> a;
+    a.add(std::make_unique<int>(2));
+    a.emplace(0, new int(0));
+    a.emplace(1, new int(1));
+    a.emplace_back(new int(3));
+    a.remove(3);
+    ASSERT_EQ(a.size(), 3U);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(*a[i], i);
+    }
+}
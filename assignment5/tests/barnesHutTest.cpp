@@ -0,0 +1,91 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// The fixture for testing the Barnes-Hut force engine.
+class BarnesHutTest : public ::testing::Test {
+protected:
+    /**
+     *  Fills the Universe with count equal-mass bodies scattered over a
+     *  square, with no dominant sun, so that every body feels a force
+     *  made up of many comparable contributions.
+     */
+    static void makeCluster(uint32_t count)
+    {
+        std::mt19937 rng(3251);
+        std::uniform_real_distribution<double> coord(-1e11, 1e11);
+        for (uint32_t i = 0; i < count; ++i) {
+            ObjectFactory::makeObject(
+                std::to_string(i), 5.9742e24, makeVector2(coord(rng), coord(rng)));
+        }
+    }
+
+    /**
+     *  Steps a fresh cluster once with the provided method and returns the
+     *  change of velocity of every body.
+     */
+    static std::vector<vector2> stepOnce(
+        Universe::ForceMethod method, double theta, uint32_t count)
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setForceMethod(method);
+        univ->setOpeningAngle(theta);
+        makeCluster(count);
+        univ->stepSimulation(1);
+
+        std::vector<vector2> deltas;
+        for (Universe::iterator i = univ->begin(); i != univ->end(); ++i) {
+            deltas.push_back((*i)->getVelocity());
+        }
+        return deltas;
+    }
+};
+
+TEST_F(BarnesHutTest, ZeroOpeningAngleMatchesBruteForce)
+{
+    std::vector<vector2> exact = stepOnce(Universe::ForceMethod::BruteForce, 0, 300);
+    std::vector<vector2> tree = stepOnce(Universe::ForceMethod::BarnesHut, 0, 300);
+    ASSERT_EQ(exact.size(), tree.size());
+    for (size_t i = 1; i < exact.size(); ++i) {
+        EXPECT_NEAR((tree[i] - exact[i]).norm(), 0.0, exact[i].norm() * 1e-12);
+    }
+}
+
+TEST_F(BarnesHutTest, ApproximationWithinTolerance)
+{
+    const double tolerance = 1e-2;
+    std::vector<vector2> exact = stepOnce(Universe::ForceMethod::BruteForce, 0, 2000);
+    std::vector<vector2> tree = stepOnce(Universe::ForceMethod::BarnesHut, 0.5, 2000);
+    ASSERT_EQ(exact.size(), tree.size());
+    double errorSq = 0;
+    double normSq = 0;
+    for (size_t i = 1; i < exact.size(); ++i) {
+        errorSq += (tree[i] - exact[i]).normSq();
+        normSq += exact[i].normSq();
+    }
+    EXPECT_LT(std::sqrt(errorSq / normSq), tolerance);
+}
+
+TEST_F(BarnesHutTest, CoincidentBodies)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setForceMethod(Universe::ForceMethod::BarnesHut);
+    ObjectFactory::makeObject("sun", 1.98892e30);
+    for (int i = 0; i < 3; ++i) {
+        ObjectFactory::makeObject("twin", 5.9742e24, makeVector2(149597870700.0, 0));
+    }
+    univ->stepSimulation(1);
+    for (Universe::iterator i = ++univ->begin(); i != univ->end(); ++i) {
+        vector2 vel = (*i)->getVelocity();
+        EXPECT_TRUE(std::isfinite(vel[0]) && std::isfinite(vel[1]));
+        EXPECT_LT(vel[0], 0.0);
+    }
+}
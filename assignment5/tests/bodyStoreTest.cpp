@@ -0,0 +1,113 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "BodyRef.h"
+#include "BodyStore.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+// The fixture for testing the packed body storage behind the Universe.
+class BodyStoreTest : public ::testing::Test {
+};
+
+TEST_F(BodyStoreTest, ObjectsProxyThePackedState)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    ObjectFactory::makeObject("sun", 10);
+    Object* planet = ObjectFactory::makeObject("planet", 2, makeVector2(1, 2), makeVector2(3, 4));
+
+    const BodyStore& bodies = univ->getBodies();
+    ASSERT_EQ(bodies.size(), 2u);
+    EXPECT_EQ(bodies.getName(1), "planet");
+    EXPECT_EQ(bodies.mass[1], 2.0);
+
+    planet->setPosition(makeVector2(5, 6));
+    planet->setVelocity(makeVector2(7, 8));
+    EXPECT_EQ(bodies.x[1], 5.0);
+    EXPECT_EQ(bodies.y[1], 6.0);
+    EXPECT_EQ(bodies.vx[1], 7.0);
+    EXPECT_EQ(bodies.vy[1], 8.0);
+
+    univ->stepSimulation(1);
+    const Object& stepped = **(++(univ->begin()));
+    assertVector(stepped.getPosition(), univ->getBodies().getPosition(1));
+    assertVector(stepped.getPosition(), makeVector2(12, 14));
+}
+
+TEST_F(BodyStoreTest, ClonesAreDetached)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    Object* live = ObjectFactory::makeObject("sun", 1, makeVector2(1, 1));
+    std::unique_ptr<Object> copy(live->clone());
+
+    copy->setPosition(makeVector2(9, 9));
+    assertVector(live->getPosition(), makeVector2(1, 1));
+    assertVector(copy->getPosition(), makeVector2(9, 9));
+    EXPECT_EQ(copy->getName(), "sun");
+    EXPECT_TRUE(*copy == *live);
+}
+
+TEST_F(BodyStoreTest, StepsKeepTheRegisteredObjects)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    ObjectFactory::makeObject("sun", 1.98892e30);
+    Object* earth = ObjectFactory::makeObject(
+        "earth", 5.9742e24, makeVector2(149597870700.0, 0), makeVector2(0, 29788.4676));
+
+    for (int step = 0; step < 10; ++step) {
+        univ->stepSimulation(1);
+        EXPECT_EQ(*(++(univ->begin())), earth);
+    }
+    assertVector(earth->getPosition(), univ->getBodies().getPosition(1));
+}
+
+TEST_F(BodyStoreTest, UpdatesAreSimultaneous)
+{
+    // Two bodies placed point-symmetrically about the sun must stay exactly
+    // symmetric if every body is updated from the state at the start of
+    // the step.
+    std::unique_ptr<Universe> univ(Universe::instance());
+    ObjectFactory::makeObject("sun", 1.98892e30);
+    Object* left = ObjectFactory::makeObject(
+        "left", 5.9742e24, makeVector2(-1.5e11, -1e10), makeVector2(0, -3e4));
+    Object* right = ObjectFactory::makeObject(
+        "right", 5.9742e24, makeVector2(1.5e11, 1e10), makeVector2(0, 3e4));
+
+    for (int step = 0; step < 100; ++step) {
+        univ->stepSimulation(3600);
+    }
+    EXPECT_EQ(left->getPosition()[0], -right->getPosition()[0]);
+    EXPECT_EQ(left->getPosition()[1], -right->getPosition()[1]);
+    EXPECT_EQ(left->getVelocity()[0], -right->getVelocity()[0]);
+    EXPECT_EQ(left->getVelocity()[1], -right->getVelocity()[1]);
+}
+
+TEST_F(BodyStoreTest, BodyRefsMatchObjects)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    Object* sun = ObjectFactory::makeObject("sun", 1.98892e30);
+    Object* earth = ObjectFactory::makeObject(
+        "earth", 5.9742e24, makeVector2(149597870700.0, 0), makeVector2(0, 29788.4676));
+
+    BodyRef ref = univ->getBody(1);
+    EXPECT_EQ(ref.getName(), earth->getName());
+    EXPECT_EQ(ref.getMass(), earth->getMass());
+    assertVector(ref.getPosition(), earth->getPosition());
+    assertVector(ref.getVelocity(), earth->getVelocity());
+
+    double fx = 0;
+    double fy = 0;
+    ref.addForce(univ->getBody(0), fx, fy);
+    vector2 force = earth->getForce(*sun);
+    EXPECT_EQ(fx, force[0]);
+    EXPECT_EQ(fy, force[1]);
+
+    const uint64_t revision = univ->getBodies().revision;
+    ref.setPosition(1, 2);
+    ref.setVelocity(3, 4);
+    assertVector(earth->getPosition(), makeVector2(1, 2));
+    assertVector(earth->getVelocity(), makeVector2(3, 4));
+    EXPECT_GT(univ->getBodies().revision, revision);
+}
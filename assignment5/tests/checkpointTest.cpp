@@ -0,0 +1,133 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Checkpointer.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// The fixture for testing asynchronous checkpoints.
+class CheckpointTest : public ::testing::Test {
+protected:
+    const std::string directory = "checkpointTest";
+    const std::string prefix = directory + "/run";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directory(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    static void makeSystem()
+    {
+        ObjectFactory::makeObject("sun", 1.98892e30);
+        ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(149597870700.0, 0), makeVector2(0, 29788.4676));
+        ObjectFactory::makeObject(
+            "mars", 6.39e23, makeVector2(0, 2.279e11), makeVector2(-24077, 0));
+    }
+};
+
+TEST_F(CheckpointTest, KeepsNewestAndResumes)
+{
+    BodyStore expected;
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        makeSystem();
+        univ->setCheckpointing(prefix, 100, 3);
+        // Flushing after every interval keeps newer checkpoints from
+        // replacing pending ones, so all ten are written
+        for (int i = 0; i < 10; ++i) {
+            univ->run(100, 60);
+            univ->flushCheckpoints();
+        }
+        expected = univ->getBodies();
+        EXPECT_EQ(univ->getStepCount(), 1000u);
+    }
+
+    std::vector<uint64_t> steps = Checkpointer::list(prefix);
+    ASSERT_EQ(steps.size(), 3u);
+    EXPECT_EQ(steps.back(), 1000u);
+
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_EQ(univ->resume(prefix), 1000u);
+    EXPECT_EQ(univ->getStepCount(), 1000u);
+    EXPECT_EQ(univ->getBodies().names, expected.names);
+    EXPECT_EQ(univ->getBodies().x, expected.x);
+    EXPECT_EQ(univ->getBodies().vy, expected.vy);
+}
+
+TEST_F(CheckpointTest, ResumeSkipsDamagedCheckpoints)
+{
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        makeSystem();
+        univ->setCheckpointing(prefix, 10, 5);
+        univ->run(30, 60);
+        univ->stopCheckpointing();
+    }
+    std::vector<uint64_t> steps = Checkpointer::list(prefix);
+    ASSERT_FALSE(steps.empty());
+    std::ofstream(Checkpointer::pathFor(prefix, 40)) << "not a snapshot";
+
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_EQ(univ->resume(prefix), steps.back());
+    EXPECT_EQ(univ->getBodies().size(), 3u);
+    EXPECT_EQ(univ->resume(directory + "/other"), 0u);
+    EXPECT_EQ(univ->getStepCount(), steps.back());
+}
+
+TEST_F(CheckpointTest, ReportsWriteErrors)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_THROW(univ->setCheckpointing(prefix, 0), std::invalid_argument);
+    makeSystem();
+    univ->setCheckpointing(directory + "/missing/run", 1);
+    univ->stepSimulation(60);
+    EXPECT_THROW(univ->flushCheckpoints(), std::system_error);
+    univ->flushCheckpoints();
+}
+
+TEST_F(CheckpointTest, FreshRunReplacesStaleCheckpoints)
+{
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        makeSystem();
+        univ->setCheckpointing(prefix, 100, 5);
+        univ->run(1000, 60);
+        univ->stopCheckpointing();
+    }
+    ASSERT_EQ(Checkpointer::list(prefix).back(), 1000u);
+
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeSystem();
+    univ->setCheckpointing(prefix, 10, 2);
+    for (int i = 0; i < 3; ++i) {
+        univ->run(10, 60);
+        univ->flushCheckpoints();
+    }
+    EXPECT_EQ(Checkpointer::list(prefix), (std::vector<uint64_t> { 20, 30 }));
+    EXPECT_EQ(univ->resume(prefix), 30u);
+}
+
+TEST_F(CheckpointTest, RejectedSettingsKeepCheckpointing)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeSystem();
+    univ->setCheckpointing(prefix, 10, 3);
+    univ->run(10, 60);
+    EXPECT_THROW(univ->setCheckpointing(prefix, 10, 0), std::invalid_argument);
+    univ->flushCheckpoints();
+    univ->run(10, 60);
+    univ->flushCheckpoints();
+    EXPECT_EQ(Checkpointer::list(prefix), (std::vector<uint64_t> { 10, 20 }));
+}
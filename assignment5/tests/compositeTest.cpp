@@ -0,0 +1,187 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "CompositeObject.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include "Visitor.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The fixture for testing composite objects and the composite force method.
+class CompositeTest : public ::testing::Test {
+protected:
+    /**
+     *  Fills the Universe with a light hub followed by systems clusters
+     *  of members equal-mass bodies, each cluster a composite a few
+     *  hundred times smaller than the spacing between clusters.
+     */
+    static void makeClusters(uint32_t systems, uint32_t members)
+    {
+        std::mt19937 rng(3251);
+        std::uniform_real_distribution<double> coord(-1e11, 1e11);
+        std::uniform_real_distribution<double> offset(-1e8, 1e8);
+        ObjectFactory::makeObject("hub", 5.9742e24);
+        for (uint32_t i = 0; i < systems; ++i) {
+            vector2 center = makeVector2(coord(rng), coord(rng));
+            CompositeObject* system = ObjectFactory::makeComposite("system" + std::to_string(i));
+            for (uint32_t j = 0; j < members; ++j) {
+                system->add(ObjectFactory::makeObject(std::to_string(i) + "_" + std::to_string(j),
+                    5.9742e24, center + makeVector2(offset(rng), offset(rng))));
+            }
+        }
+    }
+
+    /**
+     *  Steps fresh clusters once with the provided method and returns
+     *  the change of velocity of every body.
+     */
+    static std::vector<vector2> stepOnce(Universe::ForceMethod method, double theta)
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setForceMethod(method);
+        univ->setOpeningAngle(theta);
+        makeClusters(40, 10);
+        univ->stepSimulation(1);
+
+        std::vector<vector2> deltas;
+        for (Universe::iterator i = univ->begin(); i != univ->end(); ++i) {
+            deltas.push_back((*i)->getVelocity());
+        }
+        return deltas;
+    }
+};
+
+TEST_F(CompositeTest, AggregatesMembers)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    CompositeObject* system = ObjectFactory::makeComposite("earth-moon");
+    system->add(ObjectFactory::makeObject("earth", 3, makeVector2(0, 0), makeVector2(0, 4)));
+    system->add(ObjectFactory::makeObject("moon", 1, makeVector2(4, 0), makeVector2(0, -4)));
+    EXPECT_EQ(system->getName(), "earth-moon");
+    EXPECT_DOUBLE_EQ(system->getMass(), 4);
+    assertVector(system->getPosition(), makeVector2(1, 0));
+    assertVector(system->getVelocity(), makeVector2(0, 2));
+
+    system->setPosition(makeVector2(11, 5));
+    system->setVelocity(makeVector2(1, 2));
+    assertVector((*univ->begin())->getPosition(), makeVector2(10, 5));
+    assertVector((*++univ->begin())->getPosition(), makeVector2(14, 5));
+    assertVector((*univ->begin())->getVelocity(), makeVector2(1, 4));
+    assertVector(system->getVelocity(), makeVector2(1, 2));
+    EXPECT_EQ((*univ->begin())->getParent(), system);
+    ASSERT_EQ(univ->getComposites().size(), 1u);
+    EXPECT_EQ(univ->getComposites()[0], system);
+}
+
+TEST_F(CompositeTest, VisitsMembersDepthFirst)
+{
+    std::stringstream stream;
+    std::unique_ptr<Universe> univ(Universe::instance());
+    CompositeObject* outer = ObjectFactory::makeComposite("H");
+    outer->add(ObjectFactory::makeObject("e"));
+    CompositeObject* inner = ObjectFactory::makeComposite("l");
+    inner->add(ObjectFactory::makeObject("l"));
+    outer->add(inner);
+    outer->add(ObjectFactory::makeObject("o"));
+
+    PrintVisitor printer(stream);
+    outer->accept(printer);
+    EXPECT_EQ(stream.str(), "Hello");
+}
+
+TEST_F(CompositeTest, RejectsInvalidMembers)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    CompositeObject* outer = ObjectFactory::makeComposite("outer");
+    CompositeObject* inner = ObjectFactory::makeComposite("inner");
+    Object* body = ObjectFactory::makeObject("body", 1);
+    outer->add(inner);
+    inner->add(body);
+
+    EXPECT_THROW(outer->add(nullptr), std::invalid_argument);
+    EXPECT_THROW(outer->add(outer), std::invalid_argument);
+    EXPECT_THROW(outer->add(body), std::invalid_argument);
+    EXPECT_THROW(ObjectFactory::makeComposite("other")->add(inner), std::invalid_argument);
+
+    std::unique_ptr<Object> detached(body->clone());
+    EXPECT_THROW(outer->add(detached.get()), std::invalid_argument);
+    EXPECT_EQ(outer->getChildren().size(), 1u);
+}
+
+TEST_F(CompositeTest, CloneIsDetached)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    CompositeObject* system = ObjectFactory::makeComposite("system");
+    system->add(ObjectFactory::makeObject("a", 1, makeVector2(0, 0)));
+    system->add(ObjectFactory::makeObject("b", 1, makeVector2(2, 0)));
+
+    std::unique_ptr<Object> copy(system->clone());
+    auto detached = dynamic_cast<CompositeObject*>(copy.get());
+    ASSERT_NE(detached, nullptr);
+    EXPECT_FALSE(detached->isRegistered());
+    EXPECT_EQ(detached->getChildren().size(), 2u);
+    EXPECT_DOUBLE_EQ(detached->getMass(), 2);
+    detached->setPosition(makeVector2(5, 5));
+    assertVector(system->getPosition(), makeVector2(1, 0));
+    assertVector(detached->getPosition(), makeVector2(5, 5));
+}
+
+TEST_F(CompositeTest, ReleasedWithTheirMembers)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    ObjectFactory::makeComposite("system")->add(ObjectFactory::makeObject("a", 1));
+    ArrayList<Object*> snapshot = univ->getSnapshot();
+    univ->swap(snapshot);
+    EXPECT_EQ(univ->getComposites().size(), 0u);
+    EXPECT_EQ((*univ->begin())->getParent(), nullptr);
+}
+
+TEST_F(CompositeTest, SwapRejectsMembers)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    CompositeObject* system = ObjectFactory::makeComposite("system");
+    system->add(ObjectFactory::makeObject("a", 1));
+    system->add(ObjectFactory::makeObject("b", 2));
+
+    // The detached composite keeps owning its members
+    std::unique_ptr<Object> copy(system->clone());
+    ArrayList<Object*> members = dynamic_cast<CompositeObject&>(*copy).getChildren();
+    EXPECT_THROW(univ->swap(members), std::invalid_argument);
+    EXPECT_EQ(members.size(), 2u);
+    ASSERT_EQ(univ->getComposites().size(), 1u);
+    EXPECT_EQ(univ->getComposites()[0], system);
+    EXPECT_EQ((*univ->begin())->getParent(), system);
+    EXPECT_DOUBLE_EQ(system->getMass(), 3);
+}
+
+TEST_F(CompositeTest, ZeroOpeningAngleMatchesBruteForce)
+{
+    std::vector<vector2> exact = stepOnce(Universe::ForceMethod::BruteForce, 0);
+    std::vector<vector2> grouped = stepOnce(Universe::ForceMethod::Composite, 0);
+    ASSERT_EQ(exact.size(), grouped.size());
+    for (size_t i = 1; i < exact.size(); ++i) {
+        EXPECT_NEAR((grouped[i] - exact[i]).norm(), 0.0, exact[i].norm() * 1e-12);
+    }
+}
+
+TEST_F(CompositeTest, ApproximationWithinTolerance)
+{
+    const double tolerance = 1e-4;
+    std::vector<vector2> exact = stepOnce(Universe::ForceMethod::BruteForce, 0);
+    std::vector<vector2> grouped = stepOnce(Universe::ForceMethod::Composite, 0.5);
+    ASSERT_EQ(exact.size(), grouped.size());
+    double errorSq = 0;
+    double normSq = 0;
+    for (size_t i = 1; i < exact.size(); ++i) {
+        errorSq += (grouped[i] - exact[i]).normSq();
+        normSq += exact[i].normSq();
+    }
+    EXPECT_LT(std::sqrt(errorSq / normSq), tolerance);
+}
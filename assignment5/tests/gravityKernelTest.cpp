@@ -0,0 +1,113 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "GravityKernel.h"
+#include "./testHelper.h"
+#include "Universe.h"
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// The fixture for testing the vectorized pairwise force kernels.
+class GravityKernelTest : public ::testing::Test {
+protected:
+    /**
+     *  Returns the distance between a and b in units in the last place.
+     */
+    static int64_t ulpDistance(double a, double b)
+    {
+        int64_t ia;
+        int64_t ib;
+        std::memcpy(&ia, &a, sizeof(double));
+        std::memcpy(&ib, &b, sizeof(double));
+        ia = ia < 0 ? INT64_MIN - ia : ia;
+        ib = ib < 0 ? INT64_MIN - ib : ib;
+        return ia > ib ? ia - ib : ib - ia;
+    }
+
+    /**
+     *  Returns every level the current CPU can run.
+     */
+    static std::vector<gravity::SimdLevel> supportedLevels()
+    {
+        std::vector<gravity::SimdLevel> levels;
+        for (auto level : { gravity::SimdLevel::SSE2, gravity::SimdLevel::AVX2,
+                 gravity::SimdLevel::AVX512 }) {
+            if (gravity::isSupported(level)) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+};
+
+TEST_F(GravityKernelTest, PairwiseTermsWithinUlpBound)
+{
+    std::mt19937_64 rng(3251);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    std::uniform_real_distribution<double> decade(-30, 30);
+    auto scalar = gravity::getForceKernel(gravity::SimdLevel::Scalar);
+    for (auto level : supportedLevels()) {
+        auto kernel = gravity::getForceKernel(level);
+        int64_t worst = 0;
+        for (int trial = 0; trial < 20000; ++trial) {
+            // One real source in the first lane, massless copies in the rest
+            double scale = std::pow(10.0, decade(rng));
+            double xi = unit(rng) * scale;
+            double yi = unit(rng) * scale;
+            std::vector<double> x(8, unit(rng) * scale);
+            std::vector<double> y(8, unit(rng) * scale);
+            std::vector<double> mass(8, 0.0);
+            mass[0] = 5.9742e24;
+            double fx = 0;
+            double fy = 0;
+            double refX = 0;
+            double refY = 0;
+            kernel(xi, yi, 1.98892e30, x.data(), y.data(), mass.data(), 0, 8, fx, fy);
+            scalar(xi, yi, 1.98892e30, x.data(), y.data(), mass.data(), 0, 1, refX, refY);
+            worst = std::max(worst, std::max(ulpDistance(fx, refX), ulpDistance(fy, refY)));
+        }
+        EXPECT_LE(worst, gravity::MAX_PAIR_ULP) << "level " << static_cast<int>(level);
+    }
+}
+
+TEST_F(GravityKernelTest, NetForceMatchesScalar)
+{
+    std::mt19937 rng(3251);
+    std::uniform_real_distribution<double> coord(-1e11, 1e11);
+    const uint32_t count = 1003;
+    std::vector<double> x(count);
+    std::vector<double> y(count);
+    std::vector<double> mass(count, 5.9742e24);
+    for (uint32_t i = 0; i < count; ++i) {
+        x[i] = coord(rng);
+        y[i] = coord(rng);
+    }
+    // A coincident body must be ignored like in the scalar kernel
+    x[7] = x[0];
+    y[7] = y[0];
+
+    double refX = 0;
+    double refY = 0;
+    gravity::getForceKernel(gravity::SimdLevel::Scalar)(
+        x[0], y[0], mass[0], x.data(), y.data(), mass.data(), 1, count, refX, refY);
+    for (auto level : supportedLevels()) {
+        double fx = 0;
+        double fy = 0;
+        gravity::getForceKernel(level)(
+            x[0], y[0], mass[0], x.data(), y.data(), mass.data(), 1, count, fx, fy);
+        EXPECT_NEAR(fx, refX, std::abs(refX) * 1e-12);
+        EXPECT_NEAR(fy, refY, std::abs(refY) * 1e-12);
+    }
+}
+
+TEST_F(GravityKernelTest, UniverseSelectsDetectedLevel)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_EQ(univ->getSimdLevel(), gravity::detectSimdLevel());
+    univ->setSimdLevel(gravity::SimdLevel::Scalar);
+    EXPECT_EQ(univ->getSimdLevel(), gravity::SimdLevel::Scalar);
+    if (!gravity::isSupported(gravity::SimdLevel::AVX512)) {
+        EXPECT_THROW(univ->setSimdLevel(gravity::SimdLevel::AVX512), std::invalid_argument);
+    }
+}
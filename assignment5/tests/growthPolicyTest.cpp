@@ -0,0 +1,102 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "ArrayList.h"
+#include "GrowthPolicy.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The fixture for testing ArrayList growth policies and size types.
+class GrowthPolicyTest : public ::testing::Test {
+protected:
+    /**
+     *  Appends count elements to a list with the provided policy and
+     *  returns every capacity it grew to.
+     */
+    template <typename Growth> static std::vector<uint32_t> capacities(uint32_t count)
+    {
+        ArrayList<double, Growth> list;
+        std::vector<uint32_t> result;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (list.add(i) != (result.empty() ? 0 : result.back())) {
+                result.push_back(list.capacity());
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(GrowthPolicyTest, GeometricFactors)
+{
+    EXPECT_EQ(capacities<DoublingGrowth>(20), (std::vector<uint32_t> { 1, 2, 4, 8, 16, 32 }));
+    EXPECT_EQ(capacities<HalfGrowth>(20), (std::vector<uint32_t> { 1, 2, 3, 4, 6, 9, 13, 19, 28 }));
+}
+
+TEST_F(GrowthPolicyTest, PageGranular)
+{
+    // 64 doubles to a page: doubling up to a page, then eighths in whole pages
+    std::vector<uint32_t> expected = { 1, 2, 4, 8, 16, 32, 64, 128, 192, 256, 320, 384, 448, 512 };
+    EXPECT_EQ(capacities<PageGrowth<512>>(500), expected);
+    EXPECT_EQ((PageGrowth<512>::grow<double, uint32_t>(6400, 6401)), 7232u);
+
+    // A page of uint8_t-sized lists is as many elements as they can hold
+    EXPECT_EQ((PageGrowth<>::grow<int, uint8_t>(1, 2)), 2u);
+    EXPECT_EQ((PageGrowth<>::grow<int, uint8_t>(128, 129)), 255u);
+    ArrayList<int, PageGrowth<>, uint8_t> list;
+    for (int i = 0; i < 255; ++i) {
+        list.add(i);
+    }
+    EXPECT_EQ(list.capacity(), 255u);
+    EXPECT_THROW(list.add(255), std::length_error);
+}
+
+TEST_F(GrowthPolicyTest, SaturatesAtTheLargestSize)
+{
+    const uint32_t max = std::numeric_limits<uint32_t>::max();
+    EXPECT_EQ((DoublingGrowth::grow<double, uint32_t>(3000000000u, 3000000001u)), max);
+    EXPECT_EQ((HalfGrowth::grow<double, uint32_t>(4000000000u, 4000000001u)), max);
+    EXPECT_EQ((PageGrowth<>::grow<double, uint32_t>(max - 1, max)), max);
+    EXPECT_EQ((DoublingGrowth::grow<double, uint64_t>(3000000000u, 3000000001u)), 6000000000u);
+}
+
+TEST_F(GrowthPolicyTest, WideSizeType)
+{
+    ArrayList<std::string, HalfGrowth, uint64_t> list(3, "a");
+    std::vector<std::string> words = { "b", "c" };
+    list.insert(1, words.begin(), words.end());
+    list.emplace_back("d");
+    list.remove(0);
+    ASSERT_EQ(list.size(), 5u);
+    EXPECT_EQ(list[0], "b");
+    EXPECT_EQ(list[4], "d");
+    EXPECT_EQ(list.get(3), "a");
+    EXPECT_THROW(list.get(uint64_t(1) << 32), std::out_of_range);
+
+    std::string joined;
+    for (const std::string& word : ArrayList<std::string, HalfGrowth, uint64_t>(list)) {
+        joined += word;
+    }
+    EXPECT_EQ(joined, "bcaad");
+}
+
+TEST_F(GrowthPolicyTest, FullListOfSmallSizeType)
+{
+    ArrayList<int, DoublingGrowth, uint8_t> numbers;
+    ArrayList<std::string, DoublingGrowth, uint8_t> words;
+    for (int i = 0; i < 255; ++i) {
+        numbers.add(i);
+        words.add(std::to_string(i));
+    }
+    EXPECT_EQ(numbers.capacity(), 255u);
+    EXPECT_EQ(words.capacity(), 255u);
+    EXPECT_THROW(numbers.add(255), std::length_error);
+    EXPECT_THROW(numbers.emplace(0, 255), std::length_error);
+    EXPECT_THROW(words.add("255"), std::length_error);
+    EXPECT_THROW(words.emplace_back("255"), std::length_error);
+    ASSERT_EQ(numbers.size(), 255u);
+    ASSERT_EQ(words.size(), 255u);
+    EXPECT_EQ(numbers[254], 254);
+    EXPECT_EQ(words[254], "254");
+}
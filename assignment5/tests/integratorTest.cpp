@@ -0,0 +1,167 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+
+// The fixture for testing the integration schemes.
+class IntegratorTest : public ::testing::Test {
+protected:
+    static constexpr double SUN_MASS = 1.98892e30;
+    static constexpr double RADIUS = 149597870700.0;
+
+    /**
+     *  Returns the period of a circular orbit of RADIUS around the sun.
+     */
+    static double period()
+    {
+        return 2 * std::acos(-1.0) * std::sqrt(RADIUS * RADIUS * RADIUS / (Universe::G * SUN_MASS));
+    }
+
+    /**
+     *  Runs one circular orbit of the earth in the provided number of
+     *  steps and returns how far the earth ends up from where it started.
+     *  The relative change in energy is stored in drift.
+     */
+    static double orbit(Universe::Integrator scheme, int steps, double& drift)
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setIntegrator(scheme);
+        ObjectFactory::makeObject("sun", SUN_MASS);
+        double speed = std::sqrt(Universe::G * SUN_MASS / RADIUS);
+        Object* earth = ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(RADIUS, 0), makeVector2(0, speed));
+        double initial = univ->getEnergy();
+        for (int step = 0; step < steps; ++step) {
+            univ->stepSimulation(period() / steps);
+        }
+        drift = std::abs((univ->getEnergy() - initial) / initial);
+        EXPECT_EQ(univ->getBodies().x[0], 0.0);
+        EXPECT_EQ(univ->getBodies().y[0], 0.0);
+        return (earth->getPosition() - makeVector2(RADIUS, 0)).norm();
+    }
+};
+
+TEST_F(IntegratorTest, DefaultsToEuler)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_EQ(univ->getIntegrator(), Universe::Integrator::Euler);
+}
+
+TEST_F(IntegratorTest, HigherOrderSchemesCloseTheOrbit)
+{
+    double drift;
+    double euler = orbit(Universe::Integrator::Euler, 1000, drift);
+    EXPECT_GT(drift, 1e-2);
+
+    double leapfrog = orbit(Universe::Integrator::Leapfrog, 1000, drift);
+    EXPECT_LT(leapfrog, euler / 100);
+    EXPECT_LT(drift, 1e-4);
+
+    double yoshida = orbit(Universe::Integrator::Yoshida4, 1000, drift);
+    EXPECT_LT(yoshida, leapfrog / 100);
+    EXPECT_LT(drift, 1e-9);
+
+    double rk4 = orbit(Universe::Integrator::RK4, 1000, drift);
+    EXPECT_LT(rk4, leapfrog / 100);
+    EXPECT_LT(drift, 1e-9);
+}
+
+TEST_F(IntegratorTest, LeapfrogNoticesMovedBodies)
+{
+    vector2 moved = makeVector2(1e11, 2e10);
+    vector2 velocity;
+    BodyStore expected;
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setIntegrator(Universe::Integrator::Leapfrog);
+        ObjectFactory::makeObject("sun", SUN_MASS);
+        Object* earth = ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(RADIUS, 0), makeVector2(0, 3e4));
+        univ->stepSimulation(3600);
+        velocity = earth->getVelocity();
+        earth->setPosition(moved);
+        univ->stepSimulation(3600);
+        expected = univ->getBodies();
+    }
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setIntegrator(Universe::Integrator::Leapfrog);
+    ObjectFactory::makeObject("sun", SUN_MASS);
+    ObjectFactory::makeObject("earth", 5.9742e24, moved, velocity);
+    univ->stepSimulation(3600);
+    EXPECT_EQ(univ->getBodies().x, expected.x);
+    EXPECT_EQ(univ->getBodies().vx, expected.vx);
+}
+
+TEST_F(IntegratorTest, BlockRefinesOnlyTheBodyThatNeedsIt)
+{
+    // A comet with eccentricity 0.9 and a planet on a wide circular orbit
+    const double perihelion = 0.1 * RADIUS;
+    const double axis = perihelion / (1 - 0.9);
+    const double cometPeriod
+        = 2 * std::acos(-1.0) * std::sqrt(axis * axis * axis / (Universe::G * SUN_MASS));
+    const vector2 start = makeVector2(perihelion, 0);
+    const vector2 speed = makeVector2(0, std::sqrt(Universe::G * SUN_MASS * 1.9 / perihelion));
+    const double wide = 3 * RADIUS;
+
+    double errors[2];
+    const Universe::Integrator schemes[2]
+        = { Universe::Integrator::Leapfrog, Universe::Integrator::Block };
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setIntegrator(schemes[i]);
+        ObjectFactory::makeObject("sun", SUN_MASS);
+        Object* comet = ObjectFactory::makeObject("comet", 1e15, start, speed);
+        ObjectFactory::makeObject("planet", 5.9742e24, makeVector2(0, wide),
+            makeVector2(-std::sqrt(Universe::G * SUN_MASS / wide), 0));
+        for (int step = 0; step < 200; ++step) {
+            univ->stepSimulation(cometPeriod / 200);
+        }
+        errors[i] = (comet->getPosition() - start).norm();
+        EXPECT_EQ(univ->getBodies().x[0], 0.0);
+        if (schemes[i] == Universe::Integrator::Block) {
+            // Back at perihelion the comet steps far finer than the planet
+            ASSERT_EQ(univ->getBlockLevels().size(), 3u);
+            EXPECT_EQ(univ->getBlockLevels()[0], 0u);
+            EXPECT_GE(univ->getBlockLevels()[1], 5u);
+            EXPECT_EQ(univ->getBlockLevels()[2], 0u);
+        }
+    }
+    EXPECT_GT(errors[0], 1e11);
+    EXPECT_LT(errors[1], 1e8);
+}
+
+TEST_F(IntegratorTest, BlockSettings)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_EQ(univ->getBlockAccuracy(), 0.01);
+    EXPECT_EQ(univ->getMaxBlockLevel(), 16u);
+    EXPECT_THROW(univ->setBlockAccuracy(0), std::invalid_argument);
+    EXPECT_THROW(univ->setMaxBlockLevel(33), std::invalid_argument);
+}
+
+TEST_F(IntegratorTest, BlockWithoutLevelsIsLeapfrog)
+{
+    BodyStore results[2];
+    const Universe::Integrator schemes[2]
+        = { Universe::Integrator::Leapfrog, Universe::Integrator::Block };
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setIntegrator(schemes[i]);
+        univ->setMaxBlockLevel(0);
+        ObjectFactory::makeObject("sun", SUN_MASS);
+        ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(RADIUS, 0), makeVector2(0, 3e4));
+        ObjectFactory::makeObject(
+            "mars", 6.39e23, makeVector2(0, 1.5 * RADIUS), makeVector2(-2.4e4, 0));
+        for (int step = 0; step < 10; ++step) {
+            univ->stepSimulation(86400);
+        }
+        results[i] = univ->getBodies();
+    }
+    EXPECT_EQ(results[1].x, results[0].x);
+    EXPECT_EQ(results[1].vy, results[0].vy);
+}
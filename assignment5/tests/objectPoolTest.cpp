@@ -0,0 +1,70 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "ObjectPool.h"
+#include "Universe.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <vector>
+
+// The fixture for testing the slab allocator behind Object.
+class ObjectPoolTest : public ::testing::Test {
+};
+
+TEST_F(ObjectPoolTest, RecyclesBlocks)
+{
+    ObjectPool pool(24, 4);
+    EXPECT_EQ(pool.getBlockSize() % alignof(std::max_align_t), 0u);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 6; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), 6u);
+    EXPECT_EQ(pool.getCount(), 6u);
+    EXPECT_EQ(pool.getSlabCount(), 2u);
+
+    void* freed = blocks.back();
+    pool.deallocate(freed);
+    EXPECT_EQ(pool.allocate(), freed);
+    for (void* block : blocks) {
+        pool.deallocate(block);
+    }
+    EXPECT_EQ(pool.getCount(), 0u);
+    EXPECT_EQ(pool.getAllocationCount(), 7u);
+
+    for (int i = 0; i < 8; ++i) {
+        pool.allocate();
+    }
+    EXPECT_EQ(pool.getSlabCount(), 2u);
+}
+
+TEST_F(ObjectPoolTest, ObjectsComeFromThePool)
+{
+    const ObjectPool& pool = Object::getPool();
+    const uint64_t live = pool.getCount();
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        for (int i = 0; i < 300; ++i) {
+            ObjectFactory::makeObject("body", 1, makeVector2(i, 0));
+        }
+        EXPECT_EQ(pool.getCount(), live + 300);
+
+        // Stepping does not allocate Objects and snapshots reuse blocks
+        ArrayList<Object*> snapshot = univ->getSnapshot();
+        EXPECT_EQ(pool.getCount(), live + 600);
+        univ->swap(snapshot);
+        EXPECT_EQ(pool.getCount(), live + 300);
+        const uint64_t allocations = pool.getAllocationCount();
+        const uint64_t slabs = pool.getSlabCount();
+        univ->run(10, 1);
+        snapshot = univ->getSnapshot();
+        univ->swap(snapshot);
+        EXPECT_EQ(pool.getAllocationCount(), allocations + 300);
+        EXPECT_EQ(pool.getSlabCount(), slabs);
+    }
+    EXPECT_EQ(pool.getCount(), live);
+}
@@ -0,0 +1,144 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "Parser.h"
+#include "Universe.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <system_error>
+
+// The fixture for testing the Parser.
+class ParserTest : public ::testing::Test {
+protected:
+    /**
+     *  Loads text and returns the error it raised, expecting one.
+     */
+    static ParseError loadError(const std::string& text)
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        try {
+            Parser().load(text.data(), text.size());
+        } catch (const ParseError& e) {
+            return e;
+        }
+        ADD_FAILURE() << "no ParseError for: " << text;
+        return ParseError(0, 0, "");
+    }
+};
+
+TEST_F(ParserTest, LoadsBodies)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    std::string text = "{sun, 1.98892e30, [0 0], [0 0]}\r\n"
+                       "\n"
+                       "  \t\n"
+                       "{earth, +5.9742e24,\t[1.495e11 -2], [-3.5 29788.4676]}";
+    Parser().load(text.data(), text.size());
+    ASSERT_EQ(univ->getBodies().size(), 2u);
+    Object& earth = **(++univ->begin());
+    EXPECT_EQ(earth.getName(), "earth");
+    EXPECT_EQ(earth.getMass(), 5.9742e24);
+    assertVector(earth.getPosition(), makeVector2(1.495e11, -2), 0);
+    assertVector(earth.getVelocity(), makeVector2(-3.5, 29788.4676), 0);
+}
+
+TEST_F(ParserTest, LoadsFile)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    Parser().loadFile("../tests/inertiaTest.txt");
+    EXPECT_EQ(univ->getBodies().size(), 2u);
+    EXPECT_EQ(univ->getBodies().getName(1), "obj");
+    EXPECT_THROW(Parser().loadFile("../tests/missing.txt"), std::system_error);
+}
+
+TEST_F(ParserTest, ReportsLineAndColumn)
+{
+    ParseError missing = loadError("{a, 1, [0 0], [0 0]}\n{b, 1, [0 0], [0]}\n");
+    EXPECT_EQ(missing.getLine(), 2u);
+    EXPECT_EQ(missing.getColumn(), 19u);
+
+    ParseError invalid = loadError("{a, 1, [0 0], [0 0]}\n\n{b, 1, [0 0x1], [0 0]}");
+    EXPECT_EQ(invalid.getLine(), 3u);
+    EXPECT_EQ(invalid.getColumn(), 11u);
+    EXPECT_STREQ(invalid.what(), "line 3, column 11: invalid number '0x1'");
+
+    ParseError extra = loadError("{a, 1, [0 0], [0 0], 7}");
+    EXPECT_EQ(extra.getLine(), 1u);
+    EXPECT_EQ(extra.getColumn(), 22u);
+
+    EXPECT_EQ(loadError("{a, 1e999, [0 0], [0 0]}").getColumn(), 5u);
+    EXPECT_EQ(loadError("{a, +-1, [0 0], [0 0]}").getColumn(), 5u);
+}
+
+/**
+ *  Returns a script of count bodies, large enough to be split.
+ */
+static std::string makeScript(uint32_t count)
+{
+    std::string text = "{sun, 1.98892e30, [0 0], [0 0]}\n";
+    for (uint32_t i = 1; i < count; ++i) {
+        text += "{body" + std::to_string(i) + ", " + std::to_string(i * 1e20) + ", ["
+            + std::to_string(i * 1.5e9) + " " + std::to_string(i * -7.25e8) + "], ["
+            + std::to_string(i * 0.5) + " 29788.4676]}\n";
+        if (i % 1000 == 0) {
+            text += "\n";
+        }
+    }
+    return text;
+}
+
+TEST_F(ParserTest, ChunkedLoadKeepsFileOrder)
+{
+    const std::string text = makeScript(20000);
+    BodyStore serial;
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        Parser().load(text.data(), text.size());
+        serial = univ->getBodies();
+    }
+    for (unsigned threads : { 2u, 3u, 8u }) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        Parser parser;
+        parser.setThreadCount(threads);
+        EXPECT_EQ(parser.getThreadCount(), threads);
+        parser.load(text.data(), text.size());
+        EXPECT_EQ(univ->getBodies().names, serial.names);
+        EXPECT_EQ(univ->getBodies().mass, serial.mass);
+        EXPECT_EQ(univ->getBodies().x, serial.x);
+        EXPECT_EQ(univ->getBodies().vy, serial.vy);
+    }
+}
+
+TEST_F(ParserTest, ChunkedLoadReportsFirstError)
+{
+    // Break a line in the middle of the script and one near its end
+    std::string text = makeScript(20000);
+    text.insert(text.find("{body17000,"), "{bad, 1, [0 x], [0 0]}\n");
+    text.insert(text.find("{body9000,"), "{bad, 1, [0 0], [0 0]} extra\n");
+
+    uint32_t line = 0;
+    uint32_t column = 0;
+    uint32_t added = 0;
+    for (unsigned threads : { 1u, 4u }) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        Parser parser;
+        parser.setThreadCount(threads);
+        try {
+            parser.load(text.data(), text.size());
+            ADD_FAILURE() << "no ParseError";
+        } catch (const ParseError& e) {
+            if (threads == 1) {
+                line = e.getLine();
+                column = e.getColumn();
+                added = univ->getBodies().size();
+            } else {
+                EXPECT_EQ(e.getLine(), line);
+                EXPECT_EQ(e.getColumn(), column);
+                EXPECT_EQ(univ->getBodies().size(), added);
+            }
+        }
+    }
+    EXPECT_EQ(line, 9000u + 8u + 1u);
+    EXPECT_EQ(added, 9000u);
+}
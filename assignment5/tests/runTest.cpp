@@ -0,0 +1,73 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+// The fixture for testing Universe::run.
+class RunTest : public ::testing::Test {
+protected:
+    static void makeSystem()
+    {
+        ObjectFactory::makeObject("sun", 1.98892e30);
+        ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(149597870700.0, 0), makeVector2(0, 29788.4676));
+        ObjectFactory::makeObject(
+            "mars", 6.39e23, makeVector2(0, 2.279e11), makeVector2(-24077, 0));
+    }
+};
+
+TEST_F(RunTest, MatchesSteppingAndSamplesOnInterval)
+{
+    std::vector<double> expected;
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        makeSystem();
+        for (int step = 1; step <= 1000; ++step) {
+            univ->stepSimulation(60);
+            if (step % 250 == 0) {
+                for (auto object : *univ) {
+                    expected.push_back(object->getPosition()[0]);
+                    expected.push_back(object->getPosition()[1]);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeSystem();
+    std::vector<double> sampled;
+    std::vector<uint64_t> steps;
+    double samples[6];
+    univ->run(1000, 60, 250, samples, [&](uint64_t step, const double* positions) {
+        steps.push_back(step);
+        sampled.insert(sampled.end(), positions, positions + 6);
+    });
+    EXPECT_EQ(steps, (std::vector<uint64_t> { 250, 500, 750, 1000 }));
+    EXPECT_EQ(sampled, expected);
+}
+
+TEST_F(RunTest, WithoutSamples)
+{
+    BodyStore expected;
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        makeSystem();
+        for (int step = 0; step < 100; ++step) {
+            univ->stepSimulation(60);
+        }
+        expected = univ->getBodies();
+    }
+
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeSystem();
+    int calls = 0;
+    univ->run(50, 60, 0, nullptr, [&calls](uint64_t, const double*) { ++calls; });
+    univ->run(50, 60);
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(univ->getBodies().x, expected.x);
+    EXPECT_EQ(univ->getBodies().vy, expected.vy);
+}
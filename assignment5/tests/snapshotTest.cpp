@@ -0,0 +1,110 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "SnapshotFile.h"
+#include "Universe.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+// The fixture for testing binary snapshots.
+class SnapshotTest : public ::testing::Test {
+protected:
+    const char* filename = "snapshotTest.bin";
+
+    void TearDown() override
+    {
+        std::remove(filename);
+    }
+
+    static void makeSystem()
+    {
+        ObjectFactory::makeObject("sun", 1.98892e30);
+        ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(149597870700.0, 0), makeVector2(0, 29788.4676));
+        ObjectFactory::makeObject("", 1, makeVector2(-1e-300, 3), makeVector2(0.1, -0.2));
+        ObjectFactory::makeObject(
+            "halley's comet", 2.2e14, makeVector2(8.77e10, 1e9), makeVector2(-1e3, 5.45e4));
+    }
+
+    /**
+     *  Overwrites the bytes of the snapshot file at offset with value.
+     */
+    template <typename T> void patch(long offset, const T& value)
+    {
+        std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
+
+TEST_F(SnapshotTest, RoundTrip)
+{
+    BodyStore expected;
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        makeSystem();
+        univ->stepSimulation(3600);
+        univ->save(filename);
+        for (int step = 0; step < 10; ++step) {
+            univ->stepSimulation(3600);
+        }
+        expected = univ->getBodies();
+    }
+
+    // Resuming from the snapshot continues exactly where it left off
+    std::unique_ptr<Universe> univ(Universe::instance());
+    ObjectFactory::makeObject("replaced", 1);
+    univ->load(filename);
+    ASSERT_EQ(univ->getBodies().size(), 4u);
+    for (int step = 0; step < 10; ++step) {
+        univ->stepSimulation(3600);
+    }
+    EXPECT_EQ(univ->getBodies().names, expected.names);
+    EXPECT_EQ(univ->getBodies().mass, expected.mass);
+    EXPECT_EQ(univ->getBodies().x, expected.x);
+    EXPECT_EQ(univ->getBodies().vy, expected.vy);
+
+    // The new proxies see the loaded state
+    Object& comet = **(univ->begin() + 3);
+    EXPECT_EQ(comet.getName(), "halley's comet");
+    assertVector(comet.getPosition(), makeVector2(expected.x[3], expected.y[3]), 0);
+}
+
+TEST_F(SnapshotTest, EmptyUniverse)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->save(filename);
+    makeSystem();
+    univ->load(filename);
+    EXPECT_EQ(univ->getBodies().size(), 0u);
+    EXPECT_EQ(univ->begin(), univ->end());
+}
+
+TEST_F(SnapshotTest, RejectsInvalidFiles)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    EXPECT_THROW(univ->load("missing.bin"), std::system_error);
+
+    makeSystem();
+    univ->save(filename);
+    patch(8, snapshot::VERSION + 1);
+    EXPECT_THROW(univ->load(filename), std::runtime_error);
+
+    univ->save(filename);
+    patch(0, 'X');
+    EXPECT_THROW(univ->load(filename), std::runtime_error);
+
+    univ->save(filename);
+    patch(16, uint64_t(5));
+    EXPECT_THROW(univ->load(filename), std::runtime_error);
+
+    // A failed load leaves the Universe as it was
+    EXPECT_EQ(univ->getBodies().size(), 4u);
+    EXPECT_EQ((*univ->begin())->getName(), "sun");
+}
@@ -0,0 +1,72 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "Object.h"
+#include "ObjectFactory.h"
+#include "SymbolTable.h"
+#include "Universe.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// The fixture for testing interned names.
+class SymbolTableTest : public ::testing::Test {
+};
+
+TEST_F(SymbolTableTest, InternsEqualStringsOnce)
+{
+    EXPECT_EQ(symbols::intern(""), symbols::EMPTY);
+    EXPECT_EQ(symbols::lookup(symbols::EMPTY), "");
+
+    std::string name = "symbolTableTest";
+    const uint32_t id = symbols::intern(name);
+    const uint32_t size = symbols::size();
+    name[0] = 'S';
+    EXPECT_NE(symbols::intern(name), id);
+    EXPECT_EQ(symbols::intern("symbolTableTest"), id);
+    EXPECT_EQ(symbols::size(), size + 1);
+    EXPECT_EQ(symbols::lookup(id), "symbolTableTest");
+}
+
+TEST_F(SymbolTableTest, InternsBatches)
+{
+    std::vector<std::string> names = { "batch0", "batch1", "batch0", "" };
+    std::vector<std::string_view> views(names.begin(), names.end());
+    std::vector<uint32_t> ids(names.size());
+    symbols::intern(views.data(), views.size(), ids.data());
+    EXPECT_EQ(ids[0], ids[2]);
+    EXPECT_EQ(ids[1], symbols::intern("batch1"));
+    EXPECT_EQ(ids[3], symbols::EMPTY);
+    EXPECT_EQ(symbols::lookup(ids[0]), "batch0");
+}
+
+TEST_F(SymbolTableTest, InternsConcurrently)
+{
+    // Enough names to spill into a second page
+    const int count = 70000;
+    std::vector<uint32_t> first(count);
+    std::vector<uint32_t> second(count);
+    auto internAll = [count](std::vector<uint32_t>& ids) {
+        for (int i = 0; i < count; ++i) {
+            ids[i] = symbols::intern("symbol" + std::to_string(i));
+        }
+    };
+    std::thread other(internAll, std::ref(second));
+    internAll(first);
+    other.join();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(symbols::lookup(first[count - 1]), "symbol" + std::to_string(count - 1));
+}
+
+TEST_F(SymbolTableTest, ObjectsShareNames)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    Object* sun = ObjectFactory::makeObject("sun", 10);
+    std::unique_ptr<Object> copy(sun->clone());
+    EXPECT_EQ(copy->getNameId(), sun->getNameId());
+    EXPECT_EQ(copy->getName(), "sun");
+    EXPECT_EQ(univ->getBodies().getName(0), "sun");
+    EXPECT_EQ(ObjectFactory::makeObject("moon")->getName(), "moon");
+}
@@ -0,0 +1,79 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "BodyStore.h"
+#include "ObjectFactory.h"
+#include "Universe.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+
+// The fixture for testing the symmetric (Newton's third law) force method.
+class SymmetricTest : public ::testing::Test {
+protected:
+    /**
+     *  Runs a sun and count - 1 scattered bodies for a few steps and
+     *  returns the final packed state.
+     */
+    static BodyStore simulate(Universe::ForceMethod method, unsigned threads, uint32_t count)
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setForceMethod(method);
+        univ->setThreadCount(threads);
+        univ->setSimdLevel(gravity::SimdLevel::Scalar);
+        std::mt19937 rng(3251);
+        std::uniform_real_distribution<double> coord(-1e11, 1e11);
+        ObjectFactory::makeObject("sun", 1.98892e30, makeVector2(1e9, 2e9), makeVector2(5, 5));
+        for (uint32_t i = 1; i < count; ++i) {
+            ObjectFactory::makeObject(
+                std::to_string(i), 5.9742e24, makeVector2(coord(rng), coord(rng)));
+        }
+        for (int step = 0; step < 5; ++step) {
+            univ->stepSimulation(3600);
+        }
+        return univ->getBodies();
+    }
+
+    static void expectClose(const BodyStore& test, const BodyStore& correct)
+    {
+        ASSERT_EQ(test.size(), correct.size());
+        for (uint32_t i = 0; i < test.size(); ++i) {
+            assertVector(test.getVelocity(i), correct.getVelocity(i),
+                1e-9 * correct.getVelocity(i).norm());
+            assertVector(test.getPosition(i), correct.getPosition(i),
+                1e-9 * correct.getPosition(i).norm());
+        }
+    }
+};
+
+TEST_F(SymmetricTest, MatchesBruteForce)
+{
+    for (uint32_t count : { 300u, 301u }) {
+        BodyStore exact = simulate(Universe::ForceMethod::BruteForce, 1, count);
+        expectClose(simulate(Universe::ForceMethod::Symmetric, 1, count), exact);
+        expectClose(simulate(Universe::ForceMethod::Symmetric, 3, count), exact);
+    }
+}
+
+TEST_F(SymmetricTest, SunStaysFixed)
+{
+    BodyStore bodies = simulate(Universe::ForceMethod::Symmetric, 2, 50);
+    EXPECT_EQ(bodies.x[0], 1e9);
+    EXPECT_EQ(bodies.y[0], 2e9);
+    EXPECT_EQ(bodies.vx[0], 5.0);
+    EXPECT_EQ(bodies.vy[0], 5.0);
+}
+
+TEST_F(SymmetricTest, ReproducibleForFixedThreadCount)
+{
+    BodyStore first = simulate(Universe::ForceMethod::Symmetric, 4, 257);
+    BodyStore second = simulate(Universe::ForceMethod::Symmetric, 4, 257);
+    EXPECT_EQ(first.x, second.x);
+    EXPECT_EQ(first.vx, second.vx);
+}
+
+TEST_F(SymmetricTest, MoreThreadsThanFolds)
+{
+    expectClose(simulate(Universe::ForceMethod::Symmetric, 8, 5),
+        simulate(Universe::ForceMethod::BruteForce, 1, 5));
+}
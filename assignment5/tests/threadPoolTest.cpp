@@ -0,0 +1,87 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "BodyStore.h"
+#include "ObjectFactory.h"
+#include "ThreadPool.h"
+#include "Universe.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The fixture for testing the worker pool and the parallel step.
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    /**
+     *  Runs a fixed scene for a few steps with the provided settings and
+     *  returns the final packed state.
+     */
+    static BodyStore simulate(unsigned threads, Universe::ForceMethod method)
+    {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setThreadCount(threads);
+        univ->setForceMethod(method);
+        std::mt19937 rng(3251);
+        std::uniform_real_distribution<double> coord(-1e11, 1e11);
+        ObjectFactory::makeObject("sun", 1.98892e30);
+        for (int i = 1; i < 257; ++i) {
+            ObjectFactory::makeObject(std::to_string(i), 5.9742e24,
+                makeVector2(coord(rng), coord(rng)), makeVector2(coord(rng) / 1e7, 0));
+        }
+        for (int step = 0; step < 10; ++step) {
+            univ->stepSimulation(3600);
+        }
+        return univ->getBodies();
+    }
+};
+
+TEST_F(ThreadPoolTest, EveryIndexRunsOnce)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    std::vector<std::atomic<int>> hits(1001);
+    for (int round = 0; round < 3; ++round) {
+        pool.parallelFor(1001, [&hits](uint32_t begin, uint32_t end, unsigned worker) {
+            EXPECT_EQ(begin, ThreadPool::chunkBegin(1001, worker, 4));
+            for (uint32_t i = begin; i < end; ++i) {
+                ++hits[i];
+            }
+        });
+    }
+    for (auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 3);
+    }
+}
+
+TEST_F(ThreadPoolTest, ExceptionsReachTheCaller)
+{
+    ThreadPool pool(3);
+    EXPECT_THROW(pool.parallelFor(3,
+                     [](uint32_t begin, uint32_t, unsigned) {
+                         if (begin == 2) {
+                             throw std::runtime_error("chunk failed");
+                         }
+                     }),
+        std::runtime_error);
+    // The pool must remain usable
+    std::atomic<int> calls(0);
+    pool.parallelFor(3, [&calls](uint32_t, uint32_t, unsigned) { ++calls; });
+    EXPECT_EQ(calls.load(), 3);
+}
+
+TEST_F(ThreadPoolTest, ResultsIndependentOfThreadCount)
+{
+    for (auto method : { Universe::ForceMethod::BruteForce, Universe::ForceMethod::BarnesHut }) {
+        BodyStore serial = simulate(1, method);
+        for (unsigned threads : { 2u, 3u, 8u }) {
+            BodyStore parallel = simulate(threads, method);
+            EXPECT_EQ(serial.x, parallel.x);
+            EXPECT_EQ(serial.y, parallel.y);
+            EXPECT_EQ(serial.vx, parallel.vx);
+            EXPECT_EQ(serial.vy, parallel.vy);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+/* @author G. Hemingway, copyright 2020 - All rights reserved */
+#include "./testHelper.h"
+#include "ObjectFactory.h"
+#include "TrajectoryRecorder.h"
+#include "Universe.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+// The fixture for testing trajectory recording.
+class TrajectoryTest : public ::testing::Test {
+protected:
+    const char* filename = "trajectoryTest.bin";
+
+    void TearDown() override
+    {
+        std::remove(filename);
+    }
+
+    static void makeSystem()
+    {
+        ObjectFactory::makeObject("sun", 1.98892e30);
+        ObjectFactory::makeObject(
+            "earth", 5.9742e24, makeVector2(149597870700.0, 0), makeVector2(0, 29788.4676));
+        ObjectFactory::makeObject(
+            "mars", 6.39e23, makeVector2(0, 2.279e11), makeVector2(-24077, 0));
+    }
+};
+
+TEST_F(TrajectoryTest, RecordsSampledFrames)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeSystem();
+    univ->setTrajectoryRecording(filename, 10);
+    std::vector<BodyStore> expected(1, univ->getBodies());
+    for (int i = 0; i < 10; ++i) {
+        univ->run(10, 3600);
+        expected.push_back(univ->getBodies());
+    }
+    univ->stopTrajectoryRecording();
+
+    std::vector<TrajectoryRecorder::Frame> frames = TrajectoryRecorder::read(filename);
+    ASSERT_EQ(frames.size(), expected.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(frames[i].step, 10 * i);
+        EXPECT_EQ(frames[i].x, expected[i].x);
+        EXPECT_EQ(frames[i].y, expected[i].y);
+        EXPECT_EQ(frames[i].vx, expected[i].vx);
+        EXPECT_EQ(frames[i].vy, expected[i].vy);
+    }
+}
+
+TEST_F(TrajectoryTest, RejectedSettingsKeepRecording)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    makeSystem();
+    univ->setTrajectoryRecording(filename, 10);
+    univ->run(10, 3600);
+    EXPECT_THROW(univ->setTrajectoryRecording(filename, 0), std::invalid_argument);
+    EXPECT_THROW(univ->setTrajectoryRecording("missing/trajectory.bin", 10), std::system_error);
+    univ->run(10, 3600);
+    univ->flushTrajectory();
+    EXPECT_EQ(TrajectoryRecorder::read(filename).size(), 3u);
+
+    // Recording again to the same file starts it over
+    univ->setTrajectoryRecording(filename, 5);
+    univ->run(5, 3600);
+    univ->stopTrajectoryRecording();
+    std::vector<TrajectoryRecorder::Frame> frames = TrajectoryRecorder::read(filename);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].step, 20u);
+    EXPECT_EQ(frames[1].step, 25u);
+}
+
+TEST_F(TrajectoryTest, DropsFramesThatDoNotFit)
+{
+    BodyStore bodies;
+    bodies.add("sun", 1, makeVector2(0, 0), makeVector2(0, 0));
+    {
+        // Each frame is 48 bytes, so a 64 byte ring never holds two
+        TrajectoryRecorder recorder(filename, 1, 64);
+        for (uint64_t step = 0; step < 1000; ++step) {
+            recorder.onStep(step, bodies);
+        }
+        recorder.flush();
+        EXPECT_EQ(recorder.getRecorded() + recorder.getDropped(), 1000u);
+        EXPECT_GT(recorder.getRecorded(), 0u);
+    }
+    std::vector<TrajectoryRecorder::Frame> frames = TrajectoryRecorder::read(filename);
+    ASSERT_FALSE(frames.empty());
+    for (size_t i = 1; i < frames.size(); ++i) {
+        EXPECT_LT(frames[i - 1].step, frames[i].step);
+    }
+}
+
+TEST_F(TrajectoryTest, IgnoresPartialFrame)
+{
+    BodyStore bodies;
+    bodies.add("sun", 1, makeVector2(0, 0), makeVector2(0, 0));
+    {
+        TrajectoryRecorder recorder(filename, 1, 1 << 10);
+        recorder.onStep(0, bodies);
+        recorder.onStep(1, bodies);
+    }
+    {
+        std::ofstream out(filename, std::ios::binary | std::ios::app);
+        out.write("partial", 7);
+    }
+    EXPECT_EQ(TrajectoryRecorder::read(filename).size(), 2u);
+}
+
+TEST_F(TrajectoryTest, ReportsErrors)
+{
+    EXPECT_THROW(TrajectoryRecorder(filename, 0, 64), std::invalid_argument);
+    EXPECT_THROW(TrajectoryRecorder("missing/trajectory.bin", 1, 64), std::system_error);
+    {
+        std::ofstream out(filename);
+        out << "not a trajectory";
+    }
+    EXPECT_THROW(TrajectoryRecorder::read(filename), std::runtime_error);
+
+    BodyStore bodies;
+    bodies.add("sun", 1, makeVector2(0, 0), makeVector2(0, 0));
+    TrajectoryRecorder recorder("/dev/full", 1, 1 << 10);
+    recorder.onStep(0, bodies);
+    EXPECT_THROW(recorder.flush(), std::system_error);
+}
@@ -34,3 +34,58 @@ TEST_F(VisitorTest, SimpleVisitor)
     stream.flush();
     EXPECT_EQ(stream.str(), "Hello");
 }
+
+/**
+ *  A visitor that sums the same quantities as MomentumVisitor one Object
+ *  at a time.
+ */
+class ObjectMomentumVisitor : public Visitor {
+public:
+    void visit(Object& object) override
+    {
+        mass += object.getMass();
+        momentum += object.getVelocity() * object.getMass();
+        kineticEnergy += 0.5 * object.getMass() * object.getVelocity().normSq();
+    }
+
+    double mass = 0;
+    vector2 momentum;
+    double kineticEnergy = 0;
+};
+
+TEST_F(VisitorTest, BatchVisitorsMatchObjects)
+{
+    for (unsigned threads : { 1u, 3u }) {
+        std::unique_ptr<Universe> univ(Universe::instance());
+        univ->setThreadCount(threads);
+        for (int i = 0; i < 1000; ++i) {
+            ObjectFactory::makeObject("body", 1 + i % 7, makeVector2(i % 31 - 10, i % 17 - 5),
+                makeVector2(i % 13 - 6, i % 11 - 5));
+        }
+
+        ObjectMomentumVisitor expected;
+        for (Universe::iterator i = univ->begin(); i != univ->end(); ++i) {
+            (*i)->accept(expected);
+        }
+        MomentumVisitor momentum;
+        univ->visitAll(momentum);
+        EXPECT_DOUBLE_EQ(momentum.getMass(), expected.mass);
+        assertVector(momentum.getMomentum(), expected.momentum, 1e-9);
+        EXPECT_DOUBLE_EQ(momentum.getKineticEnergy(), expected.kineticEnergy);
+
+        BoundsVisitor bounds;
+        univ->visitAll(bounds);
+        ASSERT_FALSE(bounds.isEmpty());
+        assertVector(bounds.getMin(), makeVector2(-10, -5));
+        assertVector(bounds.getMax(), makeVector2(20, 11));
+    }
+}
+
+TEST_F(VisitorTest, BatchVisitorOverEmptyUniverse)
+{
+    std::unique_ptr<Universe> univ(Universe::instance());
+    univ->setThreadCount(2);
+    BoundsVisitor bounds;
+    univ->visitAll(bounds);
+    EXPECT_TRUE(bounds.isEmpty());
+}